@@ -230,6 +230,244 @@ void late_bound_can_return(MVMThreadContext *tc, void *sr_data) {
     reg->i64 = !MVM_is_null(tc, reg->o) && IS_CONCRETE(reg->o) ? 1 : 0;
 }
 
+/* Finds the number of the inline cache site whose operands start at the
+ * given offset in a frame's bytecode, or -1 if there is none there. */
+static MVMint64 find_cache_site(MVMStaticFrameBody *sfb, MVMuint32 offset) {
+    MVMuint32 lo = 0, hi = sfb->num_cache_sites;
+    while (lo < hi) {
+        MVMuint32 mid = lo + (hi - lo) / 2;
+        if (sfb->cache_site_offsets[mid] < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo < sfb->num_cache_sites && sfb->cache_site_offsets[lo] == offset ? lo : -1;
+}
+
+/* Finds the inline cache slot for the instruction whose operands start at
+ * the given offset in the current frame's bytecode, creating the frame's
+ * table of slots, one per cache site, if needed. Returns NULL when running
+ * specialized bytecode, where spesh does its own caching. */
+static MVMInlineCacheSite ** get_cache_slot(MVMThreadContext *tc, MVMuint32 offset) {
+    MVMFrame            *f    = tc->cur_frame;
+    MVMStaticFrameBody  *sfb  = &(f->static_info->body);
+    MVMInlineCacheSite **sites;
+    MVMint64             site;
+    if (f->effective_bytecode != sfb->bytecode)
+        return NULL;
+    if ((site = find_cache_site(sfb, offset)) < 0)
+        return NULL;
+    sites = sfb->cache_sites;
+    if (!sites) {
+        sites = calloc(sfb->num_cache_sites, sizeof(MVMInlineCacheSite *));
+        if (MVM_casptr(&(sfb->cache_sites), NULL, sites) != NULL) {
+            free(sites);
+            sites = sfb->cache_sites;
+        }
+    }
+    return &(sites[site]);
+}
+
+/* Checks if an entry still holds for its type. */
+typedef MVMint32 (*CacheEntryValid)(MVMInlineCacheEntry *e);
+static MVMint32 method_entry_valid(MVMInlineCacheEntry *e) {
+    return e->meth.cache == e->meth.st->method_cache;
+}
+static MVMint32 attr_entry_valid(MVMInlineCacheEntry *e) {
+    return e->attr.repr_data_version == e->attr.st->repr_data_version;
+}
+
+/* Publishes a new site with an entry added, keeping those entries of the
+ * current site that are still valid. If the site is full of valid entries,
+ * or has been replaced too often, it stays as it is. Losing a race to
+ * publish just means this entry isn't cached. The caller is responsible for
+ * write barriers on what the entry refers to. */
+static void cache_site_add(MVMThreadContext *tc, MVMInlineCacheSite **slot, MVMuint16 kind,
+                           CacheEntryValid valid, MVMInlineCacheEntry *entry) {
+    MVMInlineCacheSite *old = *slot;
+    MVMInlineCacheSite *new_site;
+    MVMuint32 i, num_valid = 0;
+    if (old) {
+        if (old->updates >= MVM_INLINE_CACHE_SITE_MAX_UPDATES)
+            return;
+        for (i = 0; i < old->num_entries; i++)
+            if (valid(&(old->entries[i])))
+                num_valid++;
+        if (num_valid == MVM_INLINE_CACHE_SITE_ENTRIES)
+            return;
+    }
+
+    new_site              = malloc(sizeof(MVMInlineCacheSite));
+    new_site->num_entries = 0;
+    new_site->updates     = old ? old->updates + 1 : 1;
+    new_site->kind        = kind;
+    new_site->prev        = old;
+    if (old)
+        for (i = 0; i < old->num_entries; i++)
+            if (valid(&(old->entries[i])))
+                new_site->entries[new_site->num_entries++] = old->entries[i];
+    new_site->entries[new_site->num_entries++] = *entry;
+
+    MVM_barrier();
+    if (MVM_casptr(slot, old, new_site) != old)
+        free(new_site);
+}
+
+/* Looks for a still valid entry for the type and name in a method site. */
+static MVMObject * method_site_lookup(MVMInlineCacheSite *site, MVMSTable *st, MVMString *name) {
+    if (site) {
+        MVMuint32 i;
+        for (i = 0; i < site->num_entries; i++) {
+            MVMMethodCacheEntry *e = &(site->entries[i].meth);
+            if (e->st == st && e->name == name && e->cache == st->method_cache)
+                return e->meth;
+        }
+    }
+    return NULL;
+}
+
+/* Adds an entry for a method just found in a type's method cache. */
+static void method_site_add(MVMThreadContext *tc, MVMInlineCacheSite **slot,
+                            MVMSTable *st, MVMString *name, MVMObject *meth) {
+    MVMCollectable     *sf_header = &(tc->cur_frame->static_info->common.header);
+    MVMInlineCacheEntry entry;
+    entry.meth.st    = st;
+    entry.meth.cache = st->method_cache;
+    entry.meth.name  = name;
+    entry.meth.meth  = meth;
+    MVM_gc_write_barrier(tc, sf_header, &(st->header));
+    MVM_gc_write_barrier(tc, sf_header, (MVMCollectable *)entry.meth.cache);
+    MVM_gc_write_barrier(tc, sf_header, (MVMCollectable *)name);
+    MVM_gc_write_barrier(tc, sf_header, (MVMCollectable *)meth);
+    cache_site_add(tc, slot, MVM_INLINE_CACHE_KIND_METHOD, method_entry_valid, &entry);
+}
+
+/* Looks up a method in the method cache of an object's type, first trying
+ * the inline cache of the instruction doing the lookup. */
+static MVMObject * find_method_inline_cached(MVMThreadContext *tc, MVMObject *obj, MVMString *name,
+                                             MVMInlineCacheSite **slot) {
+    MVMObject *meth = method_site_lookup(*slot, STABLE(obj), name);
+    if (meth)
+        return meth;
+    MVMROOT(tc, obj, {
+        MVMROOT(tc, name, {
+            meth = MVM_6model_find_method_cache_only(tc, obj, name);
+        });
+    });
+    if (MVM_is_null(tc, meth))
+        return NULL;
+    method_site_add(tc, slot, STABLE(obj), name, meth);
+    return meth;
+}
+
+/* Locates a method by name for the findmeth instruction whose operands
+ * start at the given bytecode offset, as MVM_6model_find_method does. */
+void MVM_6model_find_method_inline(MVMThreadContext *tc, MVMObject *obj, MVMString *name,
+                                   MVMRegister *res, MVMuint32 offset) {
+    MVMInlineCacheSite **slot;
+    if (!MVM_is_null(tc, obj) && (slot = get_cache_slot(tc, offset))) {
+        MVMObject *meth = find_method_inline_cached(tc, obj, name, slot);
+        if (meth) {
+            res->o = meth;
+            return;
+        }
+    }
+    MVM_6model_find_method(tc, obj, name, res);
+}
+
+/* Checks if an object can do a method for the can instruction whose
+ * operands start at the given bytecode offset. Only positive answers from
+ * the method cache are cached. */
+void MVM_6model_can_method_inline(MVMThreadContext *tc, MVMObject *obj, MVMString *name,
+                                  MVMRegister *res, MVMuint32 offset) {
+    MVMInlineCacheSite **slot;
+    if (!MVM_is_null(tc, obj) && (slot = get_cache_slot(tc, offset))) {
+        if (find_method_inline_cached(tc, obj, name, slot)) {
+            res->i64 = 1;
+            return;
+        }
+    }
+    MVM_6model_can_method(tc, obj, name, res);
+}
+
+/* Gets the hint for an attribute for the attribute access instruction
+ * whose operands start at the given bytecode offset, as the REPR's hint_for
+ * does, remembering it in the instruction's inline cache. */
+MVMint64 MVM_6model_attr_hint_inline(MVMThreadContext *tc, MVMObject *obj, MVMObject *class_handle,
+                                     MVMString *name, MVMuint32 offset) {
+    MVMSTable           *st   = STABLE(obj);
+    MVMInlineCacheSite **slot = get_cache_slot(tc, offset);
+    MVMint64             hint;
+    if (slot && *slot) {
+        MVMInlineCacheSite *site = *slot;
+        MVMuint32 i;
+        for (i = 0; i < site->num_entries; i++) {
+            MVMAttrCacheEntry *e = &(site->entries[i].attr);
+            if (e->st == st && e->class_handle == class_handle && e->name == name &&
+                    e->repr_data_version == st->repr_data_version)
+                return e->hint;
+        }
+    }
+    hint = st->REPR->attr_funcs.hint_for(tc, st, class_handle, name);
+    if (slot && hint != MVM_NO_HINT && st->REPR_data) {
+        MVMCollectable     *sf_header = &(tc->cur_frame->static_info->common.header);
+        MVMInlineCacheEntry entry;
+        entry.attr.st                = st;
+        entry.attr.repr_data_version = st->repr_data_version;
+        entry.attr.class_handle      = class_handle;
+        entry.attr.name              = name;
+        entry.attr.hint              = hint;
+        MVM_gc_write_barrier(tc, sf_header, &(st->header));
+        MVM_gc_write_barrier(tc, sf_header, (MVMCollectable *)class_handle);
+        MVM_gc_write_barrier(tc, sf_header, (MVMCollectable *)name);
+        cache_site_add(tc, slot, MVM_INLINE_CACHE_KIND_ATTR, attr_entry_valid, &entry);
+    }
+    return hint;
+}
+
+/* Marks the entries of a static frame's inline caches. */
+void MVM_6model_cache_sites_mark(MVMThreadContext *tc, MVMStaticFrameBody *body, MVMGCWorklist *worklist) {
+    MVMuint32 i, j;
+    if (!body->cache_sites)
+        return;
+    for (i = 0; i < body->num_cache_sites; i++) {
+        MVMInlineCacheSite *site = body->cache_sites[i];
+        if (!site)
+            continue;
+        for (j = 0; j < site->num_entries; j++) {
+            MVMInlineCacheEntry *e = &(site->entries[j]);
+            if (site->kind == MVM_INLINE_CACHE_KIND_METHOD) {
+                MVM_gc_worklist_add(tc, worklist, &(e->meth.st));
+                MVM_gc_worklist_add(tc, worklist, &(e->meth.cache));
+                MVM_gc_worklist_add(tc, worklist, &(e->meth.name));
+                MVM_gc_worklist_add(tc, worklist, &(e->meth.meth));
+            }
+            else {
+                MVM_gc_worklist_add(tc, worklist, &(e->attr.st));
+                MVM_gc_worklist_add(tc, worklist, &(e->attr.class_handle));
+                MVM_gc_worklist_add(tc, worklist, &(e->attr.name));
+            }
+        }
+    }
+}
+
+/* Frees a static frame's inline caches, including any sites that were
+ * replaced. */
+void MVM_6model_cache_sites_free(MVMThreadContext *tc, MVMStaticFrameBody *body) {
+    MVMuint32 i;
+    if (!body->cache_sites)
+        return;
+    for (i = 0; i < body->num_cache_sites; i++) {
+        MVMInlineCacheSite *site = body->cache_sites[i];
+        while (site) {
+            MVMInlineCacheSite *prev = site->prev;
+            free(site);
+            site = prev;
+        }
+    }
+    MVM_checked_free_null(body->cache_sites);
+}
+
 /* Checks if an object has a given type, delegating to the type_check or
  * accepts_type methods as needed. */
 static void do_accepts_type_check(MVMThreadContext *tc, MVMObject *obj, MVMObject *type, MVMRegister *res) {
@@ -214,6 +214,11 @@ struct MVMSTable {
     /* Any data specific to this type that the REPR wants to keep. */
     void *REPR_data;
 
+    /* Incremented each time the REPR data is built, by composition or
+     * deserialization, so caches of things worked out from it can tell
+     * whether they are still current. */
+    MVMuint32 repr_data_version;
+
     /* The size of an object of this type in bytes, including the
      * header. */
     MVMuint32 size;
@@ -289,6 +294,15 @@ struct MVMSTable {
     /* Also info we need to lazily deserialize the method cache. */
     MVMuint32                method_cache_offset;
     MVMSerializationContext *method_cache_sc;
+
+    /* Survival feedback for pretenuring: objects of this type allocated
+     * (in the nursery, or straight into gen2 while pretenured) and promoted
+     * out of the nursery since we last looked, and whether we currently
+     * allocate them straight into gen2. Updated without synchronization,
+     * since it only needs to be roughly right. */
+    MVMuint32 pretenure_allocs;
+    MVMuint32 pretenure_promotions;
+    MVMuint8  pretenure;
 };
 
 /* The representation operations table. Note that representations are not
@@ -545,6 +559,50 @@ struct MVMREPROps {
 /* Macros for getting/setting type-objectness. */
 #define IS_CONCRETE(o)   (!(((MVMObject *)o)->header.flags & MVM_CF_TYPE_OBJECT))
 
+/* Inline caches, kept per method lookup and hintless attribute access
+ * instruction in unspecialized bytecode. A site is never changed once
+ * published; it is replaced by a new one, which links to the old so it can
+ * be freed along with the static frame. A site that has been replaced too
+ * many times is left alone, so churning types can't grow the chain
+ * forever. Each site holds the one kind of entry its instruction needs. */
+#define MVM_INLINE_CACHE_SITE_ENTRIES       4
+#define MVM_INLINE_CACHE_SITE_MAX_UPDATES   16
+#define MVM_INLINE_CACHE_KIND_METHOD        0
+#define MVM_INLINE_CACHE_KIND_ATTR          1
+
+/* A method cache entry is only valid while its type still has the method
+ * cache the method was found in. */
+struct MVMMethodCacheEntry {
+    MVMSTable *st;
+    MVMObject *cache;
+    MVMString *name;
+    MVMObject *meth;
+};
+
+/* An attribute hint entry is valid while its type's REPR data is still the
+ * version the hint was worked out from. Comparing versions rather than REPR
+ * data pointers means a rebuild that happens to reuse the old data's
+ * address can't pass for it. */
+struct MVMAttrCacheEntry {
+    MVMSTable *st;
+    MVMuint32  repr_data_version;
+    MVMObject *class_handle;
+    MVMString *name;
+    MVMint64   hint;
+};
+
+union MVMInlineCacheEntry {
+    MVMMethodCacheEntry meth;
+    MVMAttrCacheEntry   attr;
+};
+struct MVMInlineCacheSite {
+    MVMInlineCacheEntry  entries[MVM_INLINE_CACHE_SITE_ENTRIES];
+    MVMuint32            num_entries;
+    MVMuint16            updates;
+    MVMuint16            kind;
+    MVMInlineCacheSite  *prev;
+};
+
 /* Some functions related to 6model core functionality. */
 MVMObject * MVM_6model_get_how(MVMThreadContext *tc, MVMSTable *st);
 MVMObject * MVM_6model_get_how_obj(MVMThreadContext *tc, MVMObject *st);
@@ -554,6 +612,14 @@ MVMint32 MVM_6model_find_method_spesh(MVMThreadContext *tc, MVMObject *obj, MVMS
                                       MVMint32 ss_idx, MVMRegister *res);
 MVMint64 MVM_6model_can_method_cache_only(MVMThreadContext *tc, MVMObject *obj, MVMString *name);
 void MVM_6model_can_method(MVMThreadContext *tc, MVMObject *obj, MVMString *name, MVMRegister *res);
+void MVM_6model_find_method_inline(MVMThreadContext *tc, MVMObject *obj, MVMString *name,
+                                   MVMRegister *res, MVMuint32 offset);
+void MVM_6model_can_method_inline(MVMThreadContext *tc, MVMObject *obj, MVMString *name,
+                                  MVMRegister *res, MVMuint32 offset);
+MVMint64 MVM_6model_attr_hint_inline(MVMThreadContext *tc, MVMObject *obj, MVMObject *class_handle,
+                                     MVMString *name, MVMuint32 offset);
+void MVM_6model_cache_sites_mark(MVMThreadContext *tc, MVMStaticFrameBody *body, MVMGCWorklist *worklist);
+void MVM_6model_cache_sites_free(MVMThreadContext *tc, MVMStaticFrameBody *body);
 void MVM_6model_istype(MVMThreadContext *tc, MVMObject *obj, MVMObject *type, MVMRegister *res);
 MVM_PUBLIC MVMint64 MVM_6model_istype_cache_only(MVMThreadContext *tc, MVMObject *obj, MVMObject *type);
 MVMint64 MVM_6model_try_cache_type_check(MVMThreadContext *tc, MVMObject *obj, MVMObject *type, MVMint32 *result);
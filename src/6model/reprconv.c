@@ -33,7 +33,9 @@ MVMObject * MVM_repr_clone(MVMThreadContext *tc, MVMObject *obj) {
 }
 
 void MVM_repr_compose(MVMThreadContext *tc, MVMObject *type, MVMObject *obj) {
-    REPR(type)->compose(tc, STABLE(type), obj);
+    MVMSTable *st = STABLE(type);
+    st->REPR->compose(tc, st, obj);
+    st->repr_data_version++;
 }
 
 MVM_PUBLIC void MVM_repr_pos_set_elems(MVMThreadContext *tc, MVMObject *obj, MVMint64 elems) {
@@ -17,56 +17,37 @@ static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
     return st->WHAT;
 }
 
-static void extract_key(MVMThreadContext *tc, void **kdata, size_t *klen, MVMObject *key) {
-    MVM_HASH_EXTRACT_KEY(tc, kdata, klen, key, "HashAttrStore representation requires MVMString keys")
+static void check_key(MVMThreadContext *tc, MVMObject *key) {
+    MVM_HASH_CHECK_KEY(tc, key, "HashAttrStore representation requires MVMString keys");
 }
 
 /* Copies the body of one object to another. */
 static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *dest_root, void *dest) {
     MVMHashAttrStoreBody *src_body  = (MVMHashAttrStoreBody *)src;
     MVMHashAttrStoreBody *dest_body = (MVMHashAttrStoreBody *)dest;
-    MVMHashEntry *current, *tmp;
-
-    /* NOTE: if we really wanted to, we could avoid rehashing... */
-    HASH_ITER(hash_handle, src_body->hash_head, current, tmp) {
-        size_t klen;
-        void *kdata;
-        MVMHashEntry *new_entry = malloc(sizeof(MVMHashEntry));
-        MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->key, current->key);
-        MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->value, current->value);
-        extract_key(tc, &kdata, &klen, new_entry->key);
-
-        HASH_ADD_KEYPTR(hash_handle, dest_body->hash_head, kdata, klen, new_entry);
-    }
+    MVM_hash_copy(tc, dest_root, &dest_body->hash, &src_body->hash);
 }
 
 /* Adds held objects to the GC worklist. */
 static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
     MVMHashAttrStoreBody *body = (MVMHashAttrStoreBody *)data;
-    MVMHashEntry *current, *tmp;
-
-    HASH_ITER(hash_handle, body->hash_head, current, tmp) {
-        MVM_gc_worklist_add(tc, worklist, &current->key);
-        MVM_gc_worklist_add(tc, worklist, &current->value);
-    }
+    MVM_hash_gc_mark(tc, &body->hash, worklist);
 }
 
 /* Called by the VM in order to free memory associated with this object. */
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMHashAttrStore *h = (MVMHashAttrStore *)obj;
-    MVM_HASH_DESTROY(hash_handle, MVMHashEntry, h->body.hash_head);
+    MVM_hash_destroy(tc, &h->body.hash);
 }
 
 static void get_attribute(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
         void *data, MVMObject *class_handle, MVMString *name, MVMint64 hint,
         MVMRegister *result_reg, MVMuint16 kind) {
     MVMHashAttrStoreBody *body = (MVMHashAttrStoreBody *)data;
-    void *kdata;
     MVMHashEntry *entry;
-    size_t klen;
     if (kind == MVM_reg_obj) {
-        extract_key(tc, &kdata, &klen, (MVMObject *)name);
-        HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
+        check_key(tc, (MVMObject *)name);
+        entry = MVM_hash_fetch(tc, &body->hash, name);
         result_reg->o = entry != NULL ? entry->value : tc->instance->VMNull;
     }
     else {
@@ -79,21 +60,10 @@ static void bind_attribute(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
         void *data, MVMObject *class_handle, MVMString *name, MVMint64 hint,
         MVMRegister value_reg, MVMuint16 kind) {
     MVMHashAttrStoreBody *body = (MVMHashAttrStoreBody *)data;
-    void *kdata;
     MVMHashEntry *entry;
-    size_t klen;
     if (kind == MVM_reg_obj) {
-        extract_key(tc, &kdata, &klen, (MVMObject *)name);
-
-        /* first check whether we must update the old entry. */
-        HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
-        if (!entry) {
-            entry = malloc(sizeof(MVMHashEntry));
-            HASH_ADD_KEYPTR(hash_handle, body->hash_head, kdata, klen, entry);
-        }
-        else
-            entry->hash_handle.key = (void *)kdata;
-        MVM_ASSIGN_REF(tc, &(root->header), entry->key, (MVMObject *)name);
+        check_key(tc, (MVMObject *)name);
+        entry = MVM_hash_lvivify(tc, root, &body->hash, name);
         MVM_ASSIGN_REF(tc, &(root->header), entry->value, value_reg.o);
     }
     else {
@@ -104,13 +74,8 @@ static void bind_attribute(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
 
 static MVMint64 is_attribute_initialized(MVMThreadContext *tc, MVMSTable *st, void *data, MVMObject *class_handle, MVMString *name, MVMint64 hint) {
     MVMHashAttrStoreBody *body = (MVMHashAttrStoreBody *)data;
-    void *kdata;
-    MVMHashEntry *entry;
-    size_t klen;
-
-    extract_key(tc, &kdata, &klen, (MVMObject *)name);
-    HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
-    return entry != NULL;
+    check_key(tc, (MVMObject *)name);
+    return MVM_hash_fetch(tc, &body->hash, name) != NULL;
 }
 
 static MVMint64 hint_for(MVMThreadContext *tc, MVMSTable *st, MVMObject *class_handle, MVMString *name) {
@@ -34,6 +34,7 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
     dest_body->elems = src_body->elems;
     dest_body->ssize = src_body->elems;
     dest_body->start = 0;
+    dest_body->cards = NULL;
     if (dest_body->elems > 0) {
         size_t  mem_size     = dest_body->ssize * repr_data->elem_size;
         size_t  start_pos    = src_body->start * repr_data->elem_size;
@@ -46,7 +47,71 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
     }
 }
 
-/* Adds held objects to the GC worklist. */
+/* Arrays are never inlined into other objects, so we can always get from
+ * the body back to the array. */
+#define ARRAY_FROM_BODY(data) ((MVMObject *)((char *)(data) - offsetof(MVMArray, body)))
+
+/* Number of cards needed to cover a given number of slots. */
+#define NUM_CARDS(ssize) (((ssize) + MVM_ARRAY_CARD_SLOTS - 1) >> MVM_ARRAY_CARD_BITS)
+
+/* Stores a reference into an object or string slot. This is the write
+ * barrier, plus marking the slot's card dirty if the array keeps cards. */
+static void assign_ref(MVMThreadContext *tc, MVMObject *root, MVMArrayBody *body, MVMuint64 slot, void *value) {
+    MVMCollectable *ref = (MVMCollectable *)value;
+    if ((root->header.flags & MVM_CF_SECOND_GEN) && ref && !(ref->flags & MVM_CF_SECOND_GEN)) {
+        if (body->cards)
+            body->cards[slot >> MVM_ARRAY_CARD_BITS] = 1;
+        MVM_gc_write_barrier_hit(tc, &(root->header));
+    }
+    ((MVMCollectable **)body->slots.any)[slot] = ref;
+}
+
+/* Called when references have been moved between slots; any card may now
+ * hold a nursery reference. */
+static void dirty_all_cards(MVMArrayBody *body) {
+    if (body->cards)
+        memset(body->cards, 1, NUM_CARDS(body->ssize));
+}
+
+/* Scans the dirty cards of a big gen2 array during a nursery collection,
+ * setting up the cards if this is the first time. A card stays dirty only
+ * while something in it still references a nursery object. */
+static void gc_mark_cards(MVMThreadContext *tc, MVMArrayBody *body, MVMGCWorklist *worklist) {
+    MVMCollectable **slots     = (MVMCollectable **)body->slots.any;
+    MVMuint64        first     = body->start;
+    MVMuint64        last      = body->start + body->elems;
+    MVMuint64        num_cards = NUM_CARDS(body->ssize);
+    MVMuint64        card;
+
+    if (!body->cards) {
+        body->cards = malloc(num_cards);
+        memset(body->cards, 1, num_cards);
+    }
+
+    for (card = first >> MVM_ARRAY_CARD_BITS; card < num_cards && (card << MVM_ARRAY_CARD_BITS) < last; card++) {
+        MVMuint64 from, to, i;
+        MVMuint8  dirty = 0;
+        if (!body->cards[card])
+            continue;
+        from = card << MVM_ARRAY_CARD_BITS;
+        to   = from + MVM_ARRAY_CARD_SLOTS;
+        if (from < first)
+            from = first;
+        if (to > last)
+            to = last;
+        for (i = from; i < to; i++) {
+            if (slots[i] && !(slots[i]->flags & MVM_CF_SECOND_GEN)) {
+                MVM_gc_worklist_add(tc, worklist, &slots[i]);
+                dirty = 1;
+            }
+        }
+        body->cards[card] = dirty;
+    }
+}
+
+/* Adds held objects to the GC worklist. A nursery collection only cares
+ * about references to nursery objects, so for big arrays in gen2 we need
+ * only look at the cards written to since last time. */
 static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
     MVMArrayREPRData *repr_data = (MVMArrayREPRData *)st->REPR_data;
     MVMArrayBody     *body      = (MVMArrayBody *)data;
@@ -54,17 +119,14 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
     MVMuint64         start     = body->start;
     MVMuint64         i         = 0;
     switch (repr_data->slot_type) {
-        case MVM_ARRAY_OBJ: {
-            MVMObject **slots = body->slots.o;
-            slots += start;
-            while (i < elems) {
-                MVM_gc_worklist_add(tc, worklist, &slots[i]);
-                i++;
-            }
-            break;
-        }
+        case MVM_ARRAY_OBJ:
         case MVM_ARRAY_STR: {
-            MVMString **slots = body->slots.s;
+            MVMCollectable **slots = (MVMCollectable **)body->slots.any;
+            if (!worklist->include_gen2 && body->ssize >= MVM_ARRAY_CARD_MIN_SLOTS
+                    && (ARRAY_FROM_BODY(data)->header.flags & MVM_CF_SECOND_GEN)) {
+                gc_mark_cards(tc, body, worklist);
+                break;
+            }
             slots += start;
             while (i < elems) {
                 MVM_gc_worklist_add(tc, worklist, &slots[i]);
@@ -79,6 +141,7 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMArray *arr = (MVMArray *)obj;
     MVM_checked_free_null(arr->body.slots.any);
+    MVM_checked_free_null(arr->body.cards);
 }
 
 /* Marks the representation data in an STable.*/
@@ -298,6 +361,7 @@ static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMint64
                 (char *)slots + start * repr_data->elem_size,
                 elems * repr_data->elem_size);
         body->start = 0;
+        dirty_all_cards(body);
         /* fill out any unused slots with NULL pointers or zero values */
         elems = zero_slots(tc, body, elems, ssize, repr_data->slot_type);
     }
@@ -330,6 +394,14 @@ static void set_size_internal(MVMThreadContext *tc, MVMArrayBody *body, MVMint64
     body->slots.any = slots;
     elems = zero_slots(tc, body, elems, ssize, repr_data->slot_type);
 
+    /* cover the new slots with clean cards, if we keep them */
+    if (body->cards) {
+        MVMuint64 old_cards = NUM_CARDS(body->ssize);
+        MVMuint64 new_cards = NUM_CARDS(ssize);
+        body->cards = realloc(body->cards, new_cards);
+        memset(body->cards + old_cards, 0, new_cards - old_cards);
+    }
+
     body->ssize = ssize;
 }
 
@@ -351,12 +423,12 @@ static void bind_pos(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: bindpos expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start + index], value.o);
+            assign_ref(tc, root, body, body->start + index, value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: bindpos expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start + index], value.s);
+            assign_ref(tc, root, body, body->start + index, value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -447,12 +519,12 @@ static void push(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *dat
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: push expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start + body->elems - 1], value.o);
+            assign_ref(tc, root, body, body->start + body->elems - 1, value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: push expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start + body->elems - 1], value.s);
+            assign_ref(tc, root, body, body->start + body->elems - 1, value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -605,6 +677,7 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
             elems * repr_data->elem_size);
         body->start = n;
         body->elems = elems;
+        dirty_all_cards(body);
 
         /* clear out beginning elements */
         zero_slots(tc, body, 0, n, repr_data->slot_type);
@@ -616,12 +689,12 @@ static void unshift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *
         case MVM_ARRAY_OBJ:
             if (kind != MVM_reg_obj)
                 MVM_exception_throw_adhoc(tc, "MVMArray: unshift expected object register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[body->start], value.o);
+            assign_ref(tc, root, body, body->start, value.o);
             break;
         case MVM_ARRAY_STR:
             if (kind != MVM_reg_str)
                 MVM_exception_throw_adhoc(tc, "MVMArray: unshift expected string register");
-            MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[body->start], value.s);
+            assign_ref(tc, root, body, body->start, value.s);
             break;
         case MVM_ARRAY_I64:
             if (kind != MVM_reg_int64)
@@ -816,6 +889,7 @@ static void splice(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *d
             (char *)body->slots.any + (start + offset + elems1) * repr_data->elem_size,
             (char *)body->slots.any + (start + offset + count) * repr_data->elem_size,
             tail * repr_data->elem_size);
+        dirty_all_cards(body);
     }
 
     /* now resize the array */
@@ -828,10 +902,21 @@ static void splice(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *d
             (char *)body->slots.any + (start + offset + elems1) * repr_data->elem_size,
             (char *)body->slots.any + (start + offset + count) * repr_data->elem_size,
             tail * repr_data->elem_size);
+        dirty_all_cards(body);
     }
 
-    /* now copy C<from>'s elements into SELF */
-    if (elems1 > 0) {
+    /* now copy C<from>'s elements into SELF; another array with the same
+     * native slot type can be copied in one go */
+    if (elems1 > 0 && from != root && REPR(from)->ID == MVM_REPR_ID_MVMArray
+            && MVM_ARRAY_IS_NATIVE(repr_data->slot_type)
+            && ((MVMArrayREPRData *)STABLE(from)->REPR_data)->slot_type == repr_data->slot_type) {
+        MVMArrayBody *from_body = (MVMArrayBody *)OBJECT_BODY(from);
+        memcpy(
+            (char *)body->slots.any + (body->start + offset) * repr_data->elem_size,
+            (char *)from_body->slots.any + from_body->start * repr_data->elem_size,
+            elems1 * repr_data->elem_size);
+    }
+    else if (elems1 > 0) {
         MVMint64  i;
         MVMuint16 kind;
         switch (repr_data->slot_type) {
@@ -1102,10 +1187,10 @@ static void deserialize(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, vo
     for (i = 0; i < body->elems; i++) {
         switch (repr_data->slot_type) {
             case MVM_ARRAY_OBJ:
-                MVM_ASSIGN_REF(tc, &(root->header), body->slots.o[i], MVM_serialization_read_ref(tc, reader));
+                assign_ref(tc, root, body, i, MVM_serialization_read_ref(tc, reader));
                 break;
             case MVM_ARRAY_STR:
-                MVM_ASSIGN_REF(tc, &(root->header), body->slots.s[i], MVM_serialization_read_str(tc, reader));
+                assign_ref(tc, root, body, i, MVM_serialization_read_str(tc, reader));
                 break;
             case MVM_ARRAY_I64:
                 body->slots.i64[i] = MVM_serialization_read_varint(tc, reader);
@@ -1254,3 +1339,237 @@ static const MVMREPROps this_repr = {
     MVM_REPR_ID_MVMArray,
     0, /* refs_frames */
 };
+
+/* Bulk operations on native arrays. These dispatch on the slot type once
+ * per operation rather than once per element, and work directly on the
+ * slots with memmove/memset/memchr or a plain typed loop. Those that
+ * change an array do the SC write barrier themselves, so the interpreter
+ * and the JIT can both just call them. */
+
+/* Gets the body of a concrete native array, complaining otherwise. */
+static MVMArrayBody * native_array_body(MVMThreadContext *tc, MVMObject *arr,
+                                        const char *op, MVMArrayREPRData **repr_data) {
+    if (MVM_is_null(tc, arr) || REPR(arr)->ID != MVM_REPR_ID_MVMArray || !IS_CONCRETE(arr))
+        MVM_exception_throw_adhoc(tc, "%s requires a concrete native array", op);
+    *repr_data = (MVMArrayREPRData *)STABLE(arr)->REPR_data;
+    if (!MVM_ARRAY_IS_NATIVE((*repr_data)->slot_type))
+        MVM_exception_throw_adhoc(tc, "%s requires a concrete native array", op);
+    return (MVMArrayBody *)OBJECT_BODY(arr);
+}
+
+/* Makes sure an array has at least the given number of elements. */
+static void ensure_elems(MVMThreadContext *tc, MVMArrayBody *body, MVMint64 n,
+                         MVMArrayREPRData *repr_data) {
+    if (n > (MVMint64)body->elems)
+        set_size_internal(tc, body, n, repr_data);
+}
+
+/* Copies count elements of src starting at src_pos to dest starting at
+ * dest_pos, growing dest as needed. The arrays must have the same slot
+ * type, and may be the same array. */
+void MVM_array_copy(MVMThreadContext *tc, MVMObject *dest, MVMint64 dest_pos,
+                    MVMObject *src, MVMint64 src_pos, MVMint64 count) {
+    MVMArrayREPRData *dest_repr_data, *src_repr_data;
+    MVMArrayBody     *dest_body = native_array_body(tc, dest, "arrcopy", &dest_repr_data);
+    MVMArrayBody     *src_body  = native_array_body(tc, src, "arrcopy", &src_repr_data);
+    size_t            elem_size = dest_repr_data->elem_size;
+
+    if (dest_repr_data->slot_type != src_repr_data->slot_type)
+        MVM_exception_throw_adhoc(tc, "arrcopy requires arrays of the same native type");
+    if (dest_pos < 0 || src_pos < 0 || count < 0
+            || src_pos > (MVMint64)src_body->elems
+            || count > (MVMint64)src_body->elems - src_pos
+            || count > INT64_MAX - dest_pos)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrcopy range out of bounds");
+    if (count == 0)
+        return;
+
+    /* Resize first, as when copying within an array it may move. */
+    ensure_elems(tc, dest_body, dest_pos + count, dest_repr_data);
+    memmove(
+        (char *)dest_body->slots.any + (dest_body->start + dest_pos) * elem_size,
+        (char *)src_body->slots.any + (src_body->start + src_pos) * elem_size,
+        count * elem_size);
+    MVM_SC_WB_OBJ(tc, dest);
+}
+
+/* Appends all of the elements of src to dest. */
+void MVM_array_append(MVMThreadContext *tc, MVMObject *dest, MVMObject *src) {
+    MVMArrayREPRData *dest_repr_data, *src_repr_data;
+    MVMArrayBody     *dest_body = native_array_body(tc, dest, "arrappend", &dest_repr_data);
+    MVMArrayBody     *src_body  = native_array_body(tc, src, "arrappend", &src_repr_data);
+    MVM_array_copy(tc, dest, dest_body->elems, src, 0, src_body->elems);
+}
+
+#define FILL_SLOTS(member, type) do { \
+    type *slots = body->slots.member + body->start + start; \
+    for (i = 0; i < count; i++) \
+        slots[i] = (type)value; \
+} while (0)
+
+/* Sets count elements of an integer array starting at start to value,
+ * growing the array as needed. */
+void MVM_array_fill_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value,
+                      MVMint64 start, MVMint64 count) {
+    MVMArrayREPRData *repr_data;
+    MVMArrayBody     *body = native_array_body(tc, arr, "arrfill_i", &repr_data);
+    MVMint64          i;
+    if (start < 0 || count < 0 || count > INT64_MAX - start)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrfill_i range out of bounds");
+    if (repr_data->slot_type == MVM_ARRAY_N64 || repr_data->slot_type == MVM_ARRAY_N32)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrfill_i expected an integer array");
+    ensure_elems(tc, body, start + count, repr_data);
+    switch (repr_data->slot_type) {
+        case MVM_ARRAY_I64:
+            FILL_SLOTS(i64, MVMint64);
+            break;
+        case MVM_ARRAY_I32:
+            FILL_SLOTS(i32, MVMint32);
+            break;
+        case MVM_ARRAY_I16:
+            FILL_SLOTS(i16, MVMint16);
+            break;
+        case MVM_ARRAY_U64:
+            FILL_SLOTS(u64, MVMuint64);
+            break;
+        case MVM_ARRAY_U32:
+            FILL_SLOTS(u32, MVMuint32);
+            break;
+        case MVM_ARRAY_U16:
+            FILL_SLOTS(u16, MVMuint16);
+            break;
+        case MVM_ARRAY_I8:
+        case MVM_ARRAY_U8:
+            memset(body->slots.u8 + body->start + start, (MVMuint8)value, count);
+            break;
+    }
+    MVM_SC_WB_OBJ(tc, arr);
+}
+
+/* Sets count elements of a num array starting at start to value, growing
+ * the array as needed. */
+void MVM_array_fill_n(MVMThreadContext *tc, MVMObject *arr, MVMnum64 value,
+                      MVMint64 start, MVMint64 count) {
+    MVMArrayREPRData *repr_data;
+    MVMArrayBody     *body = native_array_body(tc, arr, "arrfill_n", &repr_data);
+    MVMint64          i;
+    if (start < 0 || count < 0 || count > INT64_MAX - start)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrfill_n range out of bounds");
+    if (repr_data->slot_type != MVM_ARRAY_N64 && repr_data->slot_type != MVM_ARRAY_N32)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrfill_n expected a num array");
+    ensure_elems(tc, body, start + count, repr_data);
+    if (repr_data->slot_type == MVM_ARRAY_N64)
+        FILL_SLOTS(n64, MVMnum64);
+    else
+        FILL_SLOTS(n32, MVMnum32);
+    MVM_SC_WB_OBJ(tc, arr);
+}
+
+#define COMPARE_SLOTS(member) do { \
+    for (i = 0; i < n; i++) { \
+        if (a_body->slots.member[a_body->start + i] != b_body->slots.member[b_body->start + i]) \
+            return a_body->slots.member[a_body->start + i] < b_body->slots.member[b_body->start + i] ? -1 : 1; \
+    } \
+} while (0)
+
+/* Compares two arrays of the same slot type element by element, returning
+ * -1, 0 or 1; where one is a prefix of the other, the shorter is less. */
+MVMint64 MVM_array_compare(MVMThreadContext *tc, MVMObject *a, MVMObject *b) {
+    MVMArrayREPRData *a_repr_data, *b_repr_data;
+    MVMArrayBody     *a_body = native_array_body(tc, a, "arrcmp", &a_repr_data);
+    MVMArrayBody     *b_body = native_array_body(tc, b, "arrcmp", &b_repr_data);
+    MVMuint64         n      = a_body->elems < b_body->elems ? a_body->elems : b_body->elems;
+    MVMuint64         i;
+    if (a_repr_data->slot_type != b_repr_data->slot_type)
+        MVM_exception_throw_adhoc(tc, "arrcmp requires arrays of the same native type");
+    switch (a_repr_data->slot_type) {
+        case MVM_ARRAY_I64:
+            COMPARE_SLOTS(i64);
+            break;
+        case MVM_ARRAY_I32:
+            COMPARE_SLOTS(i32);
+            break;
+        case MVM_ARRAY_I16:
+            COMPARE_SLOTS(i16);
+            break;
+        case MVM_ARRAY_I8:
+            COMPARE_SLOTS(i8);
+            break;
+        case MVM_ARRAY_N64:
+            COMPARE_SLOTS(n64);
+            break;
+        case MVM_ARRAY_N32:
+            COMPARE_SLOTS(n32);
+            break;
+        case MVM_ARRAY_U64:
+            COMPARE_SLOTS(u64);
+            break;
+        case MVM_ARRAY_U32:
+            COMPARE_SLOTS(u32);
+            break;
+        case MVM_ARRAY_U16:
+            COMPARE_SLOTS(u16);
+            break;
+        case MVM_ARRAY_U8: {
+            int result = n ? memcmp(a_body->slots.u8 + a_body->start,
+                b_body->slots.u8 + b_body->start, n) : 0;
+            if (result)
+                return result < 0 ? -1 : 1;
+            break;
+        }
+    }
+    return a_body->elems == b_body->elems ? 0 : a_body->elems < b_body->elems ? -1 : 1;
+}
+
+#define INDEX_SLOTS(member, type) do { \
+    if ((MVMint64)(type)value != value) \
+        return -1; \
+    for (i = start; i < (MVMint64)body->elems; i++) \
+        if (body->slots.member[body->start + i] == (type)value) \
+            return i; \
+} while (0)
+
+/* Finds the index of the first element of an integer array at or after
+ * start that equals value, or -1 if there is none. For byte arrays, this
+ * is a memchr. */
+MVMint64 MVM_array_index_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value, MVMint64 start) {
+    MVMArrayREPRData *repr_data;
+    MVMArrayBody     *body = native_array_body(tc, arr, "arrindex_i", &repr_data);
+    MVMint64          i;
+    if (start < 0)
+        MVM_exception_throw_adhoc(tc, "MVMArray: arrindex_i start out of bounds");
+    if (start >= (MVMint64)body->elems)
+        return -1;
+    switch (repr_data->slot_type) {
+        case MVM_ARRAY_I64:
+            INDEX_SLOTS(i64, MVMint64);
+            break;
+        case MVM_ARRAY_I32:
+            INDEX_SLOTS(i32, MVMint32);
+            break;
+        case MVM_ARRAY_I16:
+            INDEX_SLOTS(i16, MVMint16);
+            break;
+        case MVM_ARRAY_U64:
+            INDEX_SLOTS(u64, MVMuint64);
+            break;
+        case MVM_ARRAY_U32:
+            INDEX_SLOTS(u32, MVMuint32);
+            break;
+        case MVM_ARRAY_U16:
+            INDEX_SLOTS(u16, MVMuint16);
+            break;
+        case MVM_ARRAY_I8:
+        case MVM_ARRAY_U8: {
+            MVMuint8 *from  = body->slots.u8 + body->start + start;
+            MVMuint8 *found;
+            if (repr_data->slot_type == MVM_ARRAY_I8 ? value < -128 || value > 127 : value < 0 || value > 255)
+                return -1;
+            found = memchr(from, (MVMuint8)value, body->elems - start);
+            return found ? start + (found - from) : -1;
+        }
+        default:
+            MVM_exception_throw_adhoc(tc, "MVMArray: arrindex_i expected an integer array");
+    }
+    return -1;
+}
@@ -26,6 +26,12 @@ struct MVMArrayBody {
         MVMuint8   *u8;
         void       *any;
     } slots;
+
+    /* For big object or string arrays in gen2, a dirty flag for each card
+     * of MVM_ARRAY_CARD_SLOTS slots, set when a reference to a nursery
+     * object is stored into it. A nursery collection then only needs to
+     * scan the dirty cards. NULL until such an array is first scanned. */
+    MVMuint8   *cards;
 };
 struct MVMArray {
     MVMObject common;
@@ -46,9 +52,29 @@ struct MVMArray {
 #define MVM_ARRAY_U16   10
 #define MVM_ARRAY_U8    11
 
+/* Whether a slot type holds native values rather than references. */
+#define MVM_ARRAY_IS_NATIVE(t) ((t) >= MVM_ARRAY_I64)
+
+/* Card size (as a power of two number of slots), and the slot size from
+ * which we start keeping cards. */
+#define MVM_ARRAY_CARD_BITS      7
+#define MVM_ARRAY_CARD_SLOTS     (1 << MVM_ARRAY_CARD_BITS)
+#define MVM_ARRAY_CARD_MIN_SLOTS 1024
+
 /* Function for REPR setup. */
 const MVMREPROps * MVMArray_initialize(MVMThreadContext *tc);
 
+/* Bulk operations on native arrays. */
+void MVM_array_copy(MVMThreadContext *tc, MVMObject *dest, MVMint64 dest_pos,
+                    MVMObject *src, MVMint64 src_pos, MVMint64 count);
+void MVM_array_append(MVMThreadContext *tc, MVMObject *dest, MVMObject *src);
+void MVM_array_fill_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value,
+                      MVMint64 start, MVMint64 count);
+void MVM_array_fill_n(MVMThreadContext *tc, MVMObject *arr, MVMnum64 value,
+                      MVMint64 start, MVMint64 count);
+MVMint64 MVM_array_compare(MVMThreadContext *tc, MVMObject *a, MVMObject *b);
+MVMint64 MVM_array_index_i(MVMThreadContext *tc, MVMObject *arr, MVMint64 value, MVMint64 start);
+
 /* Array REPR data specifies the type of array elements we have. */
 struct MVMArrayREPRData {
     /* The size of each element. */
@@ -48,7 +48,6 @@ static void at_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *d
             "Lexical with name '%s' does not exist in this frame",
                 MVM_string_utf8_encode_C_string(tc, name));
     }
-    MVM_string_flatten(tc, name);
     MVM_HASH_GET(tc, lexical_names, name, entry);
     if (!entry) {
        MVM_exception_throw_adhoc(tc,
@@ -75,7 +74,6 @@ static void bind_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
             "Lexical with name '%s' does not exist in this frame",
                 MVM_string_utf8_encode_C_string(tc, name));
     }
-    MVM_string_flatten(tc, name);
     MVM_HASH_GET(tc, lexical_names, name, entry);
     if (!entry) {
        MVM_exception_throw_adhoc(tc,
@@ -102,7 +100,6 @@ static MVMint64 exists_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root,
     MVMString *name = (MVMString *)key;
     if (!lexical_names)
         return 0;
-    MVM_string_flatten(tc, name);
     MVM_HASH_GET(tc, lexical_names, name, entry);
     return entry ? 1 : 0;
 }
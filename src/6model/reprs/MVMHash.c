@@ -17,54 +17,197 @@ static MVMObject * type_object_for(MVMThreadContext *tc, MVMObject *HOW) {
     return st->WHAT;
 }
 
-static void extract_key(MVMThreadContext *tc, void **kdata, size_t *klen, MVMObject *key) {
-    MVM_HASH_EXTRACT_KEY(tc, kdata, klen, key, "MVMHash representation requires MVMString keys")
+static MVMString * get_string_key(MVMThreadContext *tc, MVMObject *key) {
+    MVM_HASH_CHECK_KEY(tc, key, "MVMHash representation requires MVMString keys");
+    return (MVMString *)key;
+}
+
+/* The smallest index we make, and the most of its slots we let be used. */
+#define MIN_SLOTS 8
+#define MAX_LOAD(num_slots) ((num_slots) / 4 * 3)
+
+/* Finds the entry for a key, also giving the index slot it is in. */
+static MVMHashEntry * find_entry(MVMThreadContext *tc, MVMHashBody *body, MVMString *key,
+        MVMuint32 hash_code, MVMuint32 *slot) {
+    MVMuint32 mask, i, dist;
+    if (!body->num_slots)
+        return NULL;
+    mask = body->num_slots - 1;
+    i    = hash_code & mask;
+    for (dist = 1; dist <= body->metadata[i]; dist++) {
+        if (body->metadata[i] == dist) {
+            MVMHashEntry *entry = &(body->entries[body->slots[i]]);
+            if (entry->hash_code == hash_code && MVM_string_equal(tc, entry->key, key)) {
+                *slot = i;
+                return entry;
+            }
+        }
+        i = (i + 1) & mask;
+    }
+    return NULL;
+}
+
+/* Adds an entry to the index, moving along any that are closer to their
+ * home slot than it is to its own. There must be a free slot. */
+static void index_entry(MVMHashBody *body, MVMuint32 idx, MVMuint32 hash_code) {
+    MVMuint32 mask = body->num_slots - 1;
+    MVMuint32 i    = hash_code & mask;
+    MVMuint32 dist = 1;
+    while (body->metadata[i]) {
+        if (body->metadata[i] < dist) {
+            MVMuint32 displaced_idx  = body->slots[i];
+            MVMuint32 displaced_dist = body->metadata[i];
+            body->slots[i]    = idx;
+            body->metadata[i] = dist;
+            idx  = displaced_idx;
+            dist = displaced_dist;
+        }
+        i = (i + 1) & mask;
+        dist++;
+    }
+    body->slots[i]    = idx;
+    body->metadata[i] = dist;
+}
+
+/* Builds the index afresh with the given number of slots. */
+static void rebuild_index(MVMThreadContext *tc, MVMHashBody *body, MVMuint32 num_slots) {
+    MVMuint32 i;
+    MVM_checked_free_null(body->slots);
+    body->num_slots = num_slots;
+    body->slots     = malloc(2 * num_slots * sizeof(MVMuint32));
+    body->metadata  = body->slots + num_slots;
+    memset(body->metadata, 0, num_slots * sizeof(MVMuint32));
+    for (i = 0; i < body->num_entries; i++)
+        if (body->entries[i].hash_code)
+            index_entry(body, i, body->entries[i].hash_code);
+}
+
+/* Looks up the entry for a key, returning NULL if there is none. */
+MVMHashEntry * MVM_hash_fetch(MVMThreadContext *tc, MVMHashBody *body, MVMString *key) {
+    MVMuint32 slot;
+    if (!body->num_items)
+        return NULL;
+    return find_entry(tc, body, key, MVM_string_hash_code(tc, key), &slot);
+}
+
+/* Looks up the entry for a key, adding one with a NULL value if there is
+ * none. The entry is only valid until the hash is next added to. */
+MVMHashEntry * MVM_hash_lvivify(MVMThreadContext *tc, MVMObject *root, MVMHashBody *body, MVMString *key) {
+    MVMuint32     hash_code = MVM_string_hash_code(tc, key);
+    MVMuint32     slot, needed_slots = body->num_slots;
+    MVMHashEntry *entry     = find_entry(tc, body, key, hash_code, &slot);
+    if (entry)
+        return entry;
+
+    /* Make room for another entry. If over half of those we have were
+     * deleted, squeeze them out; otherwise grow. Squeezing renumbers the
+     * entries, so means the index must be rebuilt and iterators told. */
+    if (body->num_entries == body->alloc_entries) {
+        if (body->num_items < body->num_entries / 2) {
+            MVMuint32 i, live = 0;
+            for (i = 0; i < body->num_entries; i++)
+                if (body->entries[i].hash_code)
+                    body->entries[live++] = body->entries[i];
+            body->num_entries = live;
+            body->num_slots   = 0;
+            body->squeezes++;
+        }
+        else {
+            body->alloc_entries = body->alloc_entries ? body->alloc_entries * 2 : 4;
+            body->entries       = realloc(body->entries,
+                body->alloc_entries * sizeof(MVMHashEntry));
+        }
+    }
+    if (body->num_items + 1 > MAX_LOAD(needed_slots))
+        needed_slots = needed_slots ? needed_slots * 2 : MIN_SLOTS;
+    if (needed_slots != body->num_slots)
+        rebuild_index(tc, body, needed_slots);
+
+    /* Add the entry and index it. */
+    entry = &(body->entries[body->num_entries]);
+    MVM_ASSIGN_REF(tc, &(root->header), entry->key, key);
+    entry->value     = NULL;
+    entry->serial    = body->next_serial++;
+    entry->hash_code = hash_code;
+    index_entry(body, body->num_entries++, hash_code);
+    body->num_items++;
+    return entry;
+}
+
+/* Deletes the entry for a key, if there is one. The rest of its cluster in
+ * the index is shifted back a slot, so lookups never need to step over
+ * deleted slots. */
+void MVM_hash_delete(MVMThreadContext *tc, MVMHashBody *body, MVMString *key) {
+    MVMuint32     slot, mask, next;
+    MVMHashEntry *entry;
+    if (!body->num_items)
+        return;
+    entry = find_entry(tc, body, key, MVM_string_hash_code(tc, key), &slot);
+    if (!entry)
+        return;
+    entry->hash_code = 0;
+    entry->value     = NULL;
+    body->num_items--;
+    mask = body->num_slots - 1;
+    next = (slot + 1) & mask;
+    while (body->metadata[next] > 1) {
+        body->slots[slot]    = body->slots[next];
+        body->metadata[slot] = body->metadata[next] - 1;
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    body->metadata[slot] = 0;
+}
+
+/* Copies the live entries of one hash body into another, empty, one. Keys
+ * carry their cached hash codes, so this doesn't really rehash. */
+void MVM_hash_copy(MVMThreadContext *tc, MVMObject *dest_root, MVMHashBody *dest, MVMHashBody *src) {
+    MVMuint32 i;
+    for (i = 0; i < src->num_entries; i++) {
+        if (src->entries[i].hash_code) {
+            MVMHashEntry *new_entry = MVM_hash_lvivify(tc, dest_root, dest, src->entries[i].key);
+            MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->value, src->entries[i].value);
+        }
+    }
+}
+
+/* Adds the keys and values of a hash body to the GC worklist. The keys of
+ * deleted entries are kept alive too, for the sake of iterators. */
+void MVM_hash_gc_mark(MVMThreadContext *tc, MVMHashBody *body, MVMGCWorklist *worklist) {
+    MVMuint32 i;
+    for (i = 0; i < body->num_entries; i++) {
+        MVM_gc_worklist_add(tc, worklist, &(body->entries[i].key));
+        MVM_gc_worklist_add(tc, worklist, &(body->entries[i].value));
+    }
+}
+
+/* Frees the memory held by a hash body. */
+void MVM_hash_destroy(MVMThreadContext *tc, MVMHashBody *body) {
+    MVM_checked_free_null(body->entries);
+    MVM_checked_free_null(body->slots);
+    body->metadata    = NULL;
+    body->num_entries = body->alloc_entries = body->num_items = body->num_slots = 0;
 }
 
 /* Copies the body of one object to another. */
 static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *dest_root, void *dest) {
-    MVMHashBody *src_body  = (MVMHashBody *)src;
-    MVMHashBody *dest_body = (MVMHashBody *)dest;
-    MVMHashEntry *current, *tmp;
-
-    /* NOTE: if we really wanted to, we could avoid rehashing... */
-    HASH_ITER(hash_handle, src_body->hash_head, current, tmp) {
-        size_t klen;
-        void *kdata;
-        MVMHashEntry *new_entry = MVM_fixed_size_alloc(tc, tc->instance->fsa,
-            sizeof(MVMHashEntry));
-        MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->key, current->key);
-        MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->value, current->value);
-        extract_key(tc, &kdata, &klen, new_entry->key);
-
-        HASH_ADD_KEYPTR(hash_handle, dest_body->hash_head, kdata, klen, new_entry);
-    }
+    MVM_hash_copy(tc, dest_root, (MVMHashBody *)dest, (MVMHashBody *)src);
 }
 
 /* Adds held objects to the GC worklist. */
 static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
-    MVMHashBody *body = (MVMHashBody *)data;
-    MVMHashEntry *current, *tmp;
-
-    HASH_ITER(hash_handle, body->hash_head, current, tmp) {
-        MVM_gc_worklist_add(tc, worklist, &current->key);
-        MVM_gc_worklist_add(tc, worklist, &current->value);
-    }
+    MVM_hash_gc_mark(tc, (MVMHashBody *)data, worklist);
 }
 
 /* Called by the VM in order to free memory associated with this object. */
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMHash *h = (MVMHash *)obj;
-    MVM_HASH_DESTROY_FSA(hash_handle, MVMHashEntry, h->body.hash_head);
+    MVM_hash_destroy(tc, &h->body);
 }
 
 static void at_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key, MVMRegister *result, MVMuint16 kind) {
     MVMHashBody *body = (MVMHashBody *)data;
-    void *kdata;
-    MVMHashEntry *entry;
-    size_t klen;
-    extract_key(tc, &kdata, &klen, key);
-    HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
+    MVMHashEntry *entry = MVM_hash_fetch(tc, body, get_string_key(tc, key));
     if (kind == MVM_reg_obj)
         result->o = entry != NULL ? entry->value : tc->instance->VMNull;
     else
@@ -74,23 +217,10 @@ static void at_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *d
 
 static void bind_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key, MVMRegister value, MVMuint16 kind) {
     MVMHashBody *body = (MVMHashBody *)data;
-    void *kdata;
     MVMHashEntry *entry;
-    size_t klen;
-
-    extract_key(tc, &kdata, &klen, key);
-
-    /* first check whether we can must update the old entry. */
-    HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
-    if (!entry) {
-        entry = MVM_fixed_size_alloc(tc, tc->instance->fsa,
-            sizeof(MVMHashEntry));
-        HASH_ADD_KEYPTR(hash_handle, body->hash_head, kdata, klen, entry);
-    }
-    else
-        entry->hash_handle.key = (void *)kdata;
-    MVM_ASSIGN_REF(tc, &(root->header), entry->key, key);
+    MVMString *name = get_string_key(tc, key);
     if (kind == MVM_reg_obj) {
+        entry = MVM_hash_lvivify(tc, root, body, name);
         MVM_ASSIGN_REF(tc, &(root->header), entry->value, value.o);
     }
     else {
@@ -101,33 +231,17 @@ static void bind_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void
 
 static MVMuint64 elems(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data) {
     MVMHashBody *body = (MVMHashBody *)data;
-    return HASH_CNT(hash_handle, body->hash_head);
+    return body->num_items;
 }
 
 static MVMint64 exists_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key) {
     MVMHashBody *body = (MVMHashBody *)data;
-    void *kdata;
-    MVMHashEntry *entry;
-    size_t klen;
-    extract_key(tc, &kdata, &klen, key);
-
-    HASH_FIND(hash_handle, body->hash_head, kdata, klen, entry);
-    return entry != NULL;
+    return MVM_hash_fetch(tc, body, get_string_key(tc, key)) != NULL;
 }
 
 static void delete_key(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *data, MVMObject *key) {
     MVMHashBody *body = (MVMHashBody *)data;
-    MVMHashEntry *old_entry;
-    size_t klen;
-    void *kdata;
-    extract_key(tc, &kdata, &klen, key);
-
-    HASH_FIND(hash_handle, body->hash_head, kdata, klen, old_entry);
-    if (old_entry) {
-        HASH_DELETE(hash_handle, body->hash_head, old_entry);
-        MVM_fixed_size_free(tc, tc->instance->fsa,
-            sizeof(MVMHashEntry), old_entry);
-    }
+    MVM_hash_delete(tc, body, get_string_key(tc, key));
 }
 
 static MVMStorageSpec get_value_storage_spec(MVMThreadContext *tc, MVMSTable *st) {
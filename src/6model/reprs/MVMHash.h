@@ -1,21 +1,58 @@
-/* Representation used by VM-level hashes. */
+/* Representation used by VM-level hashes.
+ *
+ * Entries live in an array, in the order they were added, with the keys
+ * and values inline and each key's hash code alongside. An open addressing
+ * index, using Robin Hood hashing, maps keys to entries: for each of its
+ * slots, the metadata holds 0 if the slot is empty, or else one more than
+ * the slot's distance from the one its key hashes to, and the slots array
+ * holds the index of the entry. Lookups stop as soon as they meet a
+ * slot whose entry is closer to home than they are, without ever looking
+ * at its key.
+ *
+ * A deleted entry stays in the entries array, with a hash code of 0 (which
+ * MVM_string_hash_code never gives), so iterators can keep their place.
+ * When the array is full and over half of it is deleted entries, they are
+ * squeezed out instead of growing it. That renumbers the live entries, but
+ * keeps them in order, and each entry has a serial number that only grows
+ * from one entry to the next; so the hash counts its squeezes, and when the
+ * count changes iterators find their place again by serial number. */
 
 struct MVMHashEntry {
     /* key object (must be MVMString REPR) */
-    MVMObject *key;
+    MVMString *key;
 
     /* value object */
     MVMObject *value;
 
-    /* the uthash hash handle inline struct. */
-    UT_hash_handle hash_handle;
+    /* the order in which the entry was added, counting every one ever
+     * added to the hash */
+    MVMuint64 serial;
+
+    /* the key's hash code, or 0 if the entry was deleted */
+    MVMuint32 hash_code;
 };
 
 struct MVMHashBody {
-
-    /* uthash updates this pointer directly. */
-    MVMHashEntry *hash_head;
-
+    /* The entries, and how many are in use (deleted ones included), how
+     * many there is space for and how many are live. */
+    MVMHashEntry *entries;
+    MVMuint32     num_entries;
+    MVMuint32     alloc_entries;
+    MVMuint32     num_items;
+
+    /* How many times deleted entries have been squeezed out, and the
+     * serial number the next entry added will get. */
+    MVMuint32     squeezes;
+    MVMuint64     next_serial;
+
+    /* The index: a power of two number of slots (or none at all while the
+     * hash is empty), their entry indexes and their metadata. The two
+     * arrays share one allocation, which slots points to. The metadata is
+     * a full word, not a byte, so that even a pile of keys with the same
+     * hash code can never push a distance out of range. */
+    MVMuint32     num_slots;
+    MVMuint32    *slots;
+    MVMuint32    *metadata;
 };
 struct MVMHash {
     MVMObject common;
@@ -25,35 +62,56 @@ struct MVMHash {
 /* Function for REPR setup. */
 const MVMREPROps * MVMHash_initialize(MVMThreadContext *tc);
 
-#define MVM_HASH_ACTION(tc, hash, name, entry, action, member, size) \
-    action(hash_handle, hash, \
-        name->body.storage.blob_32, MVM_string_graphs(tc, name) * sizeof(size), entry); \
-
-#define MVM_HASH_ACTION_CACHE(tc, hash, name, entry, action, member, size) \
-    action(hash_handle, hash, name->body.storage.blob_32, \
-        MVM_string_graphs(tc, name) * sizeof(size), name->body.cached_hash_code, entry); \
-
-#define MVM_HASH_ACTION_SELECT(tc, hash, name, entry, action) \
-    MVM_HASH_ACTION(tc, hash, name, entry, action, storage.blob_32, MVMGrapheme32)
-
-#define MVM_HASH_ACTION_SELECT_CACHE(tc, hash, name, entry, action) \
-    MVM_HASH_ACTION_CACHE(tc, hash, name, entry, action, storage.blob_32, MVMGrapheme32) \
+/* Operations on hash bodies, also used by other hash-based REPRs. */
+MVMHashEntry * MVM_hash_fetch(MVMThreadContext *tc, MVMHashBody *body, MVMString *key);
+MVMHashEntry * MVM_hash_lvivify(MVMThreadContext *tc, MVMObject *root, MVMHashBody *body, MVMString *key);
+void MVM_hash_delete(MVMThreadContext *tc, MVMHashBody *body, MVMString *key);
+void MVM_hash_copy(MVMThreadContext *tc, MVMObject *dest_root, MVMHashBody *dest, MVMHashBody *src);
+void MVM_hash_gc_mark(MVMThreadContext *tc, MVMHashBody *body, MVMGCWorklist *worklist);
+void MVM_hash_destroy(MVMThreadContext *tc, MVMHashBody *body);
+
+/* Gets the index of the first live entry at or after the given one, or
+ * num_entries if there are no more. */
+MVM_STATIC_INLINE MVMuint32 MVM_hash_next_live(MVMHashBody *body, MVMuint32 idx) {
+    while (idx < body->num_entries && !body->entries[idx].hash_code)
+        idx++;
+    return idx;
+}
 
-#define MVM_HASH_BIND(tc, hash, name, entry) \
-    MVM_HASH_ACTION_SELECT_CACHE(tc, hash, name, entry, HASH_ADD_KEYPTR_CACHE)
+/* The VM's internal uthash hashes keyed by strings store, as the uthash key
+ * of each entry, a pointer to the entry's own MVMString * member (which the
+ * GC keeps up to date), and use MVM_string_hash_code as the hash value. Keys
+ * are compared grapheme by grapheme, so neither the stored keys nor the ones
+ * looked up need to be flattened first. The member must be set to name
+ * before the entry is found by any lookup. */
+#define MVM_HASH_BIND(tc, hash, name, entry, member) do { \
+    MVMuint32 _hb_hashv = MVM_string_hash_code(tc, name); \
+    HASH_ADD_KEYPTR_CACHE(hash_handle, hash, &(entry)->member, \
+        sizeof(MVMString *), _hb_hashv, entry); \
+} while (0)
 
-#define MVM_HASH_GET(tc, hash, name, entry) \
-    MVM_HASH_ACTION_SELECT_CACHE(tc, hash, name, entry, HASH_FIND_CACHE)
+#define MVM_HASH_GET(tc, hash, name, entry) do { \
+    entry = NULL; \
+    if (hash) { \
+        UT_hash_table  *_hg_tbl   = (hash)->hash_handle.tbl; \
+        MVMuint32       _hg_hashv = MVM_string_hash_code(tc, name); \
+        UT_hash_handle *_hg_hh    = _hg_tbl->buckets[ \
+            _hg_hashv & (_hg_tbl->num_buckets - 1)].hh_head; \
+        while (_hg_hh) { \
+            if (_hg_hh->hashv == _hg_hashv && \
+                    MVM_string_equal(tc, *(MVMString **)_hg_hh->key, name)) { \
+                DECLTYPE_ASSIGN(entry, ELMT_FROM_HH(_hg_tbl, _hg_hh)); \
+                break; \
+            } \
+            _hg_hh = _hg_hh->hh_next; \
+        } \
+    } \
+} while (0)
 
-#define MVM_HASH_EXTRACT_KEY(tc, kdata, klen, key, error) \
-if (REPR(key)->ID == MVM_REPR_ID_MVMString && IS_CONCRETE(key)) { \
-    MVM_string_flatten(tc, (MVMString *)key); \
-    *kdata = ((MVMString *)key)->body.storage.blob_32; \
-    *klen  = ((MVMString *)key)->body.num_graphs * sizeof(MVMGrapheme32); \
-} \
-else { \
-    MVM_exception_throw_adhoc(tc, error); \
-}
+#define MVM_HASH_CHECK_KEY(tc, key, error) do { \
+    if (REPR(key)->ID != MVM_REPR_ID_MVMString || !IS_CONCRETE(key)) \
+        MVM_exception_throw_adhoc(tc, error); \
+} while (0)
 
 #define MVM_HASH_DESTROY(hash_handle, hashentry_type, head_node) do { \
     hashentry_type *current, *tmp; \
@@ -28,6 +28,36 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
 static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorklist *worklist) {
     MVMIterBody  *body  = (MVMIterBody *)data;
     MVM_gc_worklist_add(tc, worklist, &body->target);
+    if (body->mode == MVM_ITER_MODE_HASH)
+        MVM_gc_worklist_add(tc, worklist, &body->hash_state.key);
+}
+
+/* Brings a hash iterator's positions up to date if the hash has squeezed
+ * out deleted entries, which renumbers the rest, since it took them. The
+ * entries stay in order of serial number, so we binary search for the
+ * first one at or after the current entry. If the current entry itself
+ * was squeezed out, curr is left pointing elsewhere; current_hash_entry
+ * notices that from the serial number. */
+static MVMHashBody * hash_iter_target(MVMThreadContext *tc, MVMIterBody *body) {
+    MVMHashBody *hash = &((MVMHash *)body->target)->body;
+    if (body->hash_state.squeezes != hash->squeezes) {
+        body->hash_state.squeezes = hash->squeezes;
+        if (body->hash_state.curr) {
+            MVMuint32 lo = 0, hi = hash->num_entries;
+            while (lo < hi) {
+                MVMuint32 mid = lo + (hi - lo) / 2;
+                if (hash->entries[mid].serial < body->hash_state.serial)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            if (lo < hash->num_entries && hash->entries[lo].serial == body->hash_state.serial)
+                body->hash_state.curr = body->hash_state.next = lo + 1;
+            else
+                body->hash_state.next = lo;
+        }
+    }
+    return hash;
 }
 
 /* Called by the VM in order to free memory associated with this object. */
@@ -102,22 +132,18 @@ static void shift(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, void *da
                 MVM_exception_throw_adhoc(tc, "Wrong register kind in iteration");
             }
             return;
-        case MVM_ITER_MODE_HASH:
-            if (!body->hash_state.curr) {
-                if (body->hash_state.next) {
-                    body->hash_state.curr = body->hash_state.next;
-                    body->hash_state.next = body->hash_state.next->hash_handle.next;
-                }
-                else {
-                    MVM_exception_throw_adhoc(tc, "Iteration past end of iterator");
-                }
-            }
-            else {
-                body->hash_state.curr = body->hash_state.curr->hash_handle.next;
-                body->hash_state.next = body->hash_state.curr->hash_handle.next;
-            }
+        case MVM_ITER_MODE_HASH: {
+            MVMHashBody *hash = hash_iter_target(tc, body);
+            MVMuint32    idx  = MVM_hash_next_live(hash, body->hash_state.next);
+            if (idx >= hash->num_entries)
+                MVM_exception_throw_adhoc(tc, "Iteration past end of iterator");
+            body->hash_state.curr   = idx + 1;
+            body->hash_state.next   = idx + 1;
+            body->hash_state.serial = hash->entries[idx].serial;
+            MVM_ASSIGN_REF(tc, &(root->header), body->hash_state.key, hash->entries[idx].key);
             value->o = root;
             return;
+        }
         default:
             MVM_exception_throw_adhoc(tc, "Unknown iteration mode");
     }
@@ -212,7 +238,9 @@ MVMObject * MVM_iter(MVMThreadContext *tc, MVMObject *target) {
             iterator = (MVMIter *)MVM_repr_alloc_init(tc,
                 MVM_hll_current(tc)->hash_iterator_type);
             iterator->body.mode = MVM_ITER_MODE_HASH;
-            iterator->body.hash_state.next = ((MVMHash *)target)->body.hash_head;
+            iterator->body.hash_state.curr     = 0;
+            iterator->body.hash_state.next     = 0;
+            iterator->body.hash_state.squeezes = ((MVMHash *)target)->body.squeezes;
             MVM_ASSIGN_REF(tc, &(iterator->common.header), iterator->body.target, target);
         }
         else if (REPR(target)->ID == MVM_REPR_ID_MVMContext) {
@@ -251,21 +279,33 @@ MVMint64 MVM_iter_istrue(MVMThreadContext *tc, MVMIter *iter) {
         case MVM_ITER_MODE_ARRAY_STR:
             return iter->body.array_state.index + 1 < iter->body.array_state.limit ? 1 : 0;
             break;
-        case MVM_ITER_MODE_HASH:
-            return iter->body.hash_state.next != NULL ? 1 : 0;
-            break;
+        case MVM_ITER_MODE_HASH: {
+            MVMHashBody *hash = hash_iter_target(tc, &iter->body);
+            return MVM_hash_next_live(hash, iter->body.hash_state.next) < hash->num_entries ? 1 : 0;
+        }
         default:
             MVM_exception_throw_adhoc(tc, "Invalid iteration mode used");
     }
 }
 
+/* Gets the hash entry a hash iterator is currently at, or NULL if it was
+ * deleted and has since been squeezed out of the hash. */
+static MVMHashEntry * current_hash_entry(MVMThreadContext *tc, MVMIter *iterator) {
+    MVMHashBody *hash = hash_iter_target(tc, &iterator->body);
+    MVMuint32    curr = iterator->body.hash_state.curr;
+    if (!curr)
+        MVM_exception_throw_adhoc(tc, "You have not advanced to the first item of the hash iterator, or have gone past the end");
+    if (curr > hash->num_entries || hash->entries[curr - 1].serial != iterator->body.hash_state.serial)
+        return NULL;
+    return &(hash->entries[curr - 1]);
+}
+
 MVMString * MVM_iterkey_s(MVMThreadContext *tc, MVMIter *iterator) {
     if (REPR(iterator)->ID != MVM_REPR_ID_MVMIter
             || iterator->body.mode != MVM_ITER_MODE_HASH)
         MVM_exception_throw_adhoc(tc, "This is not a hash iterator");
-    if (!iterator->body.hash_state.curr)
-        MVM_exception_throw_adhoc(tc, "You have not advanced to the first item of the hash iterator, or have gone past the end");
-    return (MVMString *)iterator->body.hash_state.curr->key;
+    current_hash_entry(tc, iterator);
+    return iterator->body.hash_state.key;
 }
 
 MVMObject * MVM_iterval(MVMThreadContext *tc, MVMIter *iterator) {
@@ -282,9 +322,8 @@ MVMObject * MVM_iterval(MVMThreadContext *tc, MVMIter *iterator) {
         REPR(target)->pos_funcs.at_pos(tc, STABLE(target), target, OBJECT_BODY(target), body->array_state.index, &result, MVM_reg_obj);
     }
     else if (iterator->body.mode == MVM_ITER_MODE_HASH) {
-        if (!iterator->body.hash_state.curr)
-        MVM_exception_throw_adhoc(tc, "You have not advanced to the first item of the hash iterator, or have gone past the end");
-        result.o = iterator->body.hash_state.curr->value;
+        MVMHashEntry *entry = current_hash_entry(tc, iterator);
+        result.o = entry ? entry->value : NULL;
         if (!result.o)
             result.o = tc->instance->VMNull;
     }
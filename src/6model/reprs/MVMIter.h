@@ -13,11 +13,24 @@ struct MVMIterBody {
     /* array or hash being iterated */
     MVMObject *target;
 
-    /* next hash item to give or next array index */
+    /* hash entry positions or array indexes */
     union {
         struct {
-            MVMHashEntry *next;
-            MVMHashEntry *curr;
+            /* One more than the index of the current entry, or 0 if the
+             * iterator has not yet been advanced. */
+            MVMuint32 curr;
+
+            /* The index to look for the next live entry from. */
+            MVMuint32 next;
+
+            /* The hash's squeeze count when the positions were taken. */
+            MVMuint32 squeezes;
+
+            /* The serial number and key of the current entry, to find our
+             * place by after a squeeze, and to still have the key if the
+             * entry was deleted and squeezed out. */
+            MVMuint64  serial;
+            MVMString *key;
         } hash_state;
         struct {
             MVMint64 index;
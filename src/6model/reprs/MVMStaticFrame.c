@@ -66,18 +66,15 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
     {
         MVMLexicalRegistry *current, *tmp;
 
-        /* NOTE: if we really wanted to, we could avoid rehashing... */
+        /* Keys carry their cached hash codes, so this doesn't really rehash. */
         HASH_ITER(hash_handle, src_body->lexical_names, current, tmp) {
-            size_t klen;
-            void *kdata;
             MVMLexicalRegistry *new_entry = malloc(sizeof(MVMLexicalRegistry));
 
             /* don't need to clone the string */
             MVM_ASSIGN_REF(tc, &(dest_root->header), new_entry->key, current->key);
             new_entry->value = current->value;
 
-            MVM_HASH_EXTRACT_KEY(tc, &kdata, &klen, current->key, "really broken")
-            HASH_ADD_KEYPTR(hash_handle, dest_body->lexical_names, kdata, klen, new_entry);
+            MVM_HASH_BIND(tc, dest_body->lexical_names, new_entry->key, new_entry, key);
         }
     }
 
@@ -148,6 +145,9 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
                 MVM_gc_worklist_add(tc, worklist, &body->static_env[i].o);
     }
 
+    /* Inline method caches. */
+    MVM_6model_cache_sites_mark(tc, body, worklist);
+
     /* Spesh slots. */
     if (body->num_spesh_candidates) {
         MVMint32 i, j;
@@ -180,6 +180,8 @@ static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     if (!body->fully_deserialized)
         return;
     MVM_checked_free_null(body->instr_offsets);
+    MVM_checked_free_null(body->cache_site_offsets);
+    MVM_6model_cache_sites_free(tc, body);
     MVM_checked_free_null(body->handlers);
     MVM_checked_free_null(body->static_env);
     MVM_checked_free_null(body->static_env_flags);
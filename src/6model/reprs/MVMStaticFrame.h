@@ -84,6 +84,15 @@ struct MVMStaticFrameBody {
     /* Cached instruction offsets */
     MVMuint8 *instr_offsets;
 
+    /* Operand offsets of the instructions with inline caches, in bytecode
+     * order; a site's number is its index here. Found by validation. */
+    MVMuint32 *cache_site_offsets;
+    MVMuint32  num_cache_sites;
+
+    /* Inline caches for those instructions, indexed by site number;
+     * created lazily. */
+    MVMInlineCacheSite **cache_sites;
+
     /* Does the frame have an exit handler we need to run? */
     MVMuint8 has_exit_handler;
 
@@ -40,10 +40,12 @@ static void copy_to(MVMThreadContext *tc, MVMSTable *st, void *src, MVMObject *d
                 memcpy(dest_body->storage.blob_8, src_body->storage.blob_8,
                     dest_body->num_graphs);
             }
+            break;
         case MVM_STRING_STRAND:
             dest_body->storage.strands = malloc(dest_body->num_strands * sizeof(MVMStringStrand));
             memcpy(dest_body->storage.strands, src_body->storage.strands,
                 dest_body->num_strands * sizeof(MVMStringStrand));
+            break;
         default:
             MVM_exception_throw_adhoc(tc, "Internal string corruption");
     }
@@ -64,6 +66,7 @@ static void gc_mark(MVMThreadContext *tc, MVMSTable *st, void *data, MVMGCWorkli
 static void gc_free(MVMThreadContext *tc, MVMObject *obj) {
     MVMString *str = (MVMString *)obj;
     MVM_checked_free_null(str->body.storage.any);
+    MVM_checked_free_null(str->body.strand_offsets);
     str->body.num_graphs = str->body.num_strands = 0;
 }
 
@@ -1,24 +1,31 @@
 /* Representation used by VM-level strings.
  *
- * Strings come in one of 3 forms today, with 1 expected future form:
+ * Strings come in one of 4 forms:
  *   - 32-bit someday-NFG buffer of codepoints, maybe with synthetics
  *   - 8-bit buffer of codepoints that all fall in the ASCII range
- *   - Buffer of strands
- *   - (LATER) 8-bit buffer of codepoints with negatives as synthetics (we
+ *   - 8-bit buffer of codepoints that all fall in the Latin-1 range (we
  *     draw out a distinction with the ASCII range buffer because we can do
- *     some I/O simplifications when we know all is in the ASCII range).
+ *     some I/O simplifications when we know all is in the ASCII range)
+ *   - Buffer of strands
+ *
+ * Strings are produced in one of the 8-bit forms whenever all of their
+ * graphemes fit, and only use 32 bits per grapheme when they do not.
  *
  * A buffer of strands represents a string made up of other non-strand
  * strings. That is, there's no recursive strands. This simplifies the
  * process of iteration enormously. A strand may refer to just part of
  * another string by specifying offsets. Furthermore, it may specify a
  * repetition count.
+ *
+ * Random access into a strand string uses a table of the grapheme offset
+ * each strand starts at, which is built the first time it's needed and
+ * then kept alongside the strands.
  */
 
 /* Kinds of grapheme we may hold in a string. */
 typedef MVMint32 MVMGrapheme32;
 typedef MVMint8  MVMGraphemeASCII;
-typedef MVMint8  MVMGrapheme8;       /* Future use */
+typedef MVMuint8 MVMGrapheme8;
 
 /* What kind of data is a string storing? */
 #define MVM_STRING_GRAPHEME_32      0
@@ -48,6 +55,17 @@ struct MVMStringBody {
     MVMuint16 num_strands;
     MVMuint32 num_graphs;
     MVMint32  cached_hash_code;
+
+    /* Strand that the last random access landed in; a hint for the next. */
+    MVMuint16 last_strand;
+
+    /* Non-zero if this is the interned copy of the string, and so the only
+     * interned string with these graphemes. */
+    MVMuint16 interned;
+
+    /* For strand strings, num_strands + 1 cumulative grapheme offsets of
+     * the strands, or NULL if not yet built. */
+    MVMuint32 *strand_offsets;
 };
 
 /* A strand of a string. */
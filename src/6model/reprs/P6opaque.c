@@ -54,20 +54,111 @@ static void set_obj_at_offset(MVMThreadContext *tc, MVMObject *root, void *data,
     MVM_ASSIGN_REF(tc, &(root->header), *((MVMObject **)location), value);
 }
 
+/* Object bodies are laid out an attribute at a time, in slot order. Each
+ * attribute goes into the first gap left by alignment padding before it
+ * that it fits in at its own alignment, or else after all of the others.
+ * That way an int8 or num32 after a pointer doesn't cost a whole word, but
+ * an attribute's offset still only depends on those before it, so a type
+ * lays out the attributes of its parents exactly as they do (which
+ * change_type relies on). The used map has a byte per byte of body. */
+typedef struct {
+    MVMuint8  *used;
+    MVMuint32  used_alloc;
+    MVMuint32  size;
+} P6opaqueLayout;
+static void layout_init(P6opaqueLayout *layout) {
+    layout->used       = NULL;
+    layout->used_alloc = 0;
+    layout->size       = sizeof(MVMP6opaqueBody);
+}
+static MVMuint32 layout_place(P6opaqueLayout *layout, MVMuint32 bytes, MVMuint32 align) {
+    MVMuint32 offset = sizeof(MVMP6opaqueBody);
+    MVMuint32 i;
+    if (offset % align)
+        offset += align - offset % align;
+    for (; offset + bytes <= layout->size; offset += align) {
+        for (i = 0; i < bytes; i++)
+            if (layout->used[offset + i])
+                break;
+        if (i == bytes)
+            break;
+    }
+    if (offset + bytes > layout->size) {
+        offset = layout->size;
+        if (offset % align)
+            offset += align - offset % align;
+        layout->size = offset + bytes;
+    }
+    if (layout->size > layout->used_alloc) {
+        MVMuint32 new_alloc = layout->size * 2;
+        layout->used = realloc(layout->used, new_alloc);
+        memset(layout->used + layout->used_alloc, 0, new_alloc - layout->used_alloc);
+        layout->used_alloc = new_alloc;
+    }
+    memset(layout->used + offset, 1, bytes);
+    return offset;
+}
+static void layout_destroy(P6opaqueLayout *layout) {
+    MVM_checked_free_null(layout->used);
+}
+
+/* Places an attribute of the given flattened type, or a reference if it is
+ * NULL. Sub-byte native ints get a byte of their own. */
+static MVMuint32 layout_place_attribute(MVMThreadContext *tc, P6opaqueLayout *layout, MVMSTable *flat_st) {
+    if (flat_st) {
+        MVMStorageSpec spec = flat_st->REPR->get_storage_spec(tc, flat_st);
+        return layout_place(layout, (spec.bits + 7) / 8, spec.align ? spec.align : 1);
+    }
+    return layout_place(layout, sizeof(MVMObject *), ALIGNOF(void *));
+}
+
+/* Builds the index from class key and name to slot over the name map.
+ * Entries go in name map order, so where a class has two attributes of
+ * the same name the lookup still finds the first, as a scan would. */
+static void build_name_index(MVMThreadContext *tc, MVMP6opaqueREPRData *repr_data) {
+    MVMP6opaqueNameMap *map = repr_data->name_to_index_mapping;
+    MVMuint32 total = 0, size = 4, i, j;
+    repr_data->name_index      = NULL;
+    repr_data->name_index_mask = 0;
+    if (!map)
+        return;
+    for (i = 0; map[i].class_key != NULL; i++)
+        total += map[i].num_attrs;
+    if (total == 0)
+        return;
+    while (size < total * 2)
+        size *= 2;
+    repr_data->name_index      = malloc(size * sizeof(MVMP6opaqueNameIndexEntry));
+    repr_data->name_index_mask = size - 1;
+    for (i = 0; i < size; i++)
+        repr_data->name_index[i].map_idx = MVM_P6OPAQUE_NAME_INDEX_EMPTY;
+    for (i = 0; map[i].class_key != NULL; i++) {
+        for (j = 0; j < map[i].num_attrs; j++) {
+            MVMuint32 hash_code = MVM_string_hash_code(tc, map[i].names[j]);
+            MVMuint32 k = hash_code & repr_data->name_index_mask;
+            while (repr_data->name_index[k].map_idx != MVM_P6OPAQUE_NAME_INDEX_EMPTY)
+                k = (k + 1) & repr_data->name_index_mask;
+            repr_data->name_index[k].hash_code = hash_code;
+            repr_data->name_index[k].map_idx   = i;
+            repr_data->name_index[k].attr_idx  = j;
+        }
+    }
+}
+
 /* Helper for finding a slot number. */
 static MVMint64 try_get_slot(MVMThreadContext *tc, MVMP6opaqueREPRData *repr_data, MVMObject *class_key, MVMString *name) {
-    if (repr_data->name_to_index_mapping) {
-        MVMP6opaqueNameMap *cur_map_entry = repr_data->name_to_index_mapping;
-        while (cur_map_entry->class_key != NULL) {
-            if (cur_map_entry->class_key == class_key) {
-                MVMint16 i;
-                for (i = 0; i < cur_map_entry->num_attrs; i++) {
-                    if (MVM_string_equal(tc, cur_map_entry->names[i], name)) {
-                        return cur_map_entry->slots[i];
-                    }
-                }
+    if (repr_data->name_index) {
+        MVMuint32 hash_code = MVM_string_hash_code(tc, name);
+        MVMuint32 k = hash_code & repr_data->name_index_mask;
+        while (repr_data->name_index[k].map_idx != MVM_P6OPAQUE_NAME_INDEX_EMPTY) {
+            MVMP6opaqueNameIndexEntry *entry = &(repr_data->name_index[k]);
+            if (entry->hash_code == hash_code) {
+                MVMP6opaqueNameMap *map_entry = &(repr_data->name_to_index_mapping[entry->map_idx]);
+                if (map_entry->class_key == class_key &&
+                        MVM_string_equal(tc, map_entry->names[entry->attr_idx], name))
+                    return map_entry->slots[entry->attr_idx];
             }
-            cur_map_entry++;
+            k = (k + 1) & repr_data->name_index_mask;
         }
     }
     return -1;
@@ -225,6 +316,7 @@ static void gc_free_repr_data(MVMThreadContext *tc, MVMSTable *st) {
         }
         MVM_checked_free_null(repr_data->name_to_index_mapping);
     }
+    MVM_checked_free_null(repr_data->name_index);
 
     MVM_checked_free_null(repr_data->attribute_offsets);
     MVM_checked_free_null(repr_data->flattened_stables);
@@ -581,6 +673,7 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
                cur_init_slot, cur_mark_slot, cur_cleanup_slot, cur_unbox_slot,
                unboxed_type, i;
     MVMObject *info;
+    P6opaqueLayout layout;
 
     MVMStringConsts       str_consts = tc->instance->str_consts;
     MVMString        * const str_avc = str_consts.auto_viv_container;
@@ -654,12 +747,12 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
     mro_pos          = mro_count;
     cur_slot         = 0;
     cur_type         = 0;
-    cur_alloc_addr   = sizeof(MVMP6opaqueBody);
     cur_obj_attr     = 0;
     cur_init_slot    = 0;
     cur_mark_slot    = 0;
     cur_cleanup_slot = 0;
     cur_unbox_slot   = 0;
+    layout_init(&layout);
     while (mro_pos--) {
         /* Get info for the class at the current position. */
         MVMObject *class_info = MVM_repr_at_pos_o(tc, info, mro_pos);
@@ -687,8 +780,6 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
             MVMint64 is_box_target = REPR(attr_info)->ass_funcs.exists_key(tc,
                 STABLE(attr_info), attr_info, OBJECT_BODY(attr_info), (MVMObject *)str_box_target);
             MVMint8 inlined = 0;
-            MVMuint32 bits;
-            MVMuint32 align;
 
             /* Ensure we have a name. */
             if (MVM_is_null(tc, name_obj))
@@ -704,16 +795,12 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
 
             /* Consider the type. */
             unboxed_type = MVM_STORAGE_SPEC_BP_NONE;
-            bits         = sizeof(MVMObject *) * 8;
-            align        = ALIGNOF(void *);
             if (!MVM_is_null(tc, type)) {
                 /* Get the storage spec of the type and see what it wants. */
                 MVMStorageSpec spec = REPR(type)->get_storage_spec(tc, STABLE(type));
                 if (spec.inlineable == MVM_STORAGE_SPEC_INLINED) {
                     /* Yes, it's something we'll flatten. */
                     unboxed_type = spec.boxed_primitive;
-                    bits = spec.bits;
-                    align = spec.align;
                     MVM_ASSIGN_REF(tc, &(st->header), repr_data->flattened_stables[cur_slot], STABLE(type));
                     inlined = 1;
 
@@ -770,14 +857,9 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
                 }
             }
 
-            /* C structure needs careful alignment. If cur_alloc_addr is not
-             * aligned to align bytes (cur_alloc_addr % align), make sure it is
-             * before we add the next element. */
-            if (cur_alloc_addr % align) {
-                cur_alloc_addr += align - cur_alloc_addr % align;
-            }
-
-            /* Attribute will live at the current position in the object. */
+            /* Find the attribute a place in the object. */
+            cur_alloc_addr = layout_place_attribute(tc, &layout,
+                repr_data->flattened_stables[cur_slot]);
             repr_data->attribute_offsets[cur_slot] = cur_alloc_addr;
 
             /* Handle object attributes, which need marking and may have auto-viv needs. */
@@ -811,9 +893,6 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
                         "Associative delegate attribute must be a reference type");
             }
 
-            /* Add the required space for this type. */
-            cur_alloc_addr += bits / 8;
-
             /* Increment slot count. */
             cur_slot++;
         }
@@ -823,7 +902,8 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
     }
 
     /* Add allocated amount for body to have total object size. */
-    st->size = sizeof(MVMP6opaque) + (cur_alloc_addr - sizeof(MVMP6opaqueBody));
+    st->size = sizeof(MVMP6opaque) + (layout.size - sizeof(MVMP6opaqueBody));
+    layout_destroy(&layout);
 
     /* Add sentinels/counts. */
     repr_data->gc_obj_mark_offsets_count = cur_obj_attr;
@@ -831,6 +911,9 @@ static void compose(MVMThreadContext *tc, MVMSTable *st, MVMObject *info_hash) {
     repr_data->gc_mark_slots[cur_mark_slot] = -1;
     repr_data->gc_cleanup_slots[cur_cleanup_slot] = -1;
 
+    /* Index the name map for attribute lookups. */
+    build_name_index(tc, repr_data);
+
     /* Install representation data. */
     st->REPR_data = repr_data;
 }
@@ -840,28 +923,18 @@ static void deserialize_stable_size(MVMThreadContext *tc, MVMSTable *st, MVMSeri
     /* To calculate size, we need number of attributes and to know about
      * anything flattend in. */
     MVMint64  num_attributes = MVM_serialization_read_varint(tc, reader);
-    MVMuint32 cur_offset = sizeof(MVMP6opaque);
     MVMint64  i;
+    P6opaqueLayout layout;
+    layout_init(&layout);
     for (i = 0; i < num_attributes; i++) {
-        if (MVM_serialization_read_varint(tc, reader)) {
-            MVMSTable *st = MVM_serialization_read_stable_ref(tc, reader);
-            MVMStorageSpec ss = st->REPR->get_storage_spec(tc, st);
-            if (ss.inlineable) {
-                /* TODO: Review if/when we get sub-byte things. */
-                if (cur_offset % ss.align) {
-                    cur_offset += ss.align - cur_offset % ss.align;
-                }
-                cur_offset += ss.bits / 8;
-            }
-            else
-                cur_offset += sizeof(MVMObject *);
-        }
-        else {
-            cur_offset += sizeof(MVMObject *);
-        }
+        MVMSTable *flat_st = NULL;
+        if (MVM_serialization_read_varint(tc, reader))
+            flat_st = MVM_serialization_read_stable_ref(tc, reader);
+        layout_place_attribute(tc, &layout, flat_st);
     }
 
-    st->size = cur_offset;
+    st->size = sizeof(MVMP6opaque) + (layout.size - sizeof(MVMP6opaqueBody));
+    layout_destroy(&layout);
 }
 
 /* Serializes the REPR data. */
@@ -931,6 +1004,7 @@ static void serialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializ
 static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerializationReader *reader) {
     MVMuint16 i, j, num_classes, cur_offset;
     MVMint16 cur_initialize_slot, cur_gc_mark_slot, cur_gc_cleanup_slot;
+    P6opaqueLayout layout;
 
     MVMP6opaqueREPRData *repr_data = malloc(sizeof(MVMP6opaqueREPRData));
 
@@ -1004,26 +1078,22 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
     repr_data->gc_mark_slots       = (MVMint16 *)malloc((repr_data->num_attributes + 1) * sizeof(MVMint16));
     repr_data->gc_cleanup_slots    = (MVMint16 *)malloc((repr_data->num_attributes + 1) * sizeof(MVMint16));
     repr_data->gc_obj_mark_offsets_count = 0;
-    cur_offset          = sizeof(MVMP6opaqueBody);
+    layout_init(&layout);
     cur_initialize_slot = 0;
     cur_gc_mark_slot    = 0;
     cur_gc_cleanup_slot = 0;
     for (i = 0; i < repr_data->num_attributes; i++) {
-        if (repr_data->flattened_stables[i] == NULL) {
-            /* Store position. */
-            repr_data->attribute_offsets[i] = cur_offset;
+        /* Store position. */
+        cur_offset = layout_place_attribute(tc, &layout, repr_data->flattened_stables[i]);
+        repr_data->attribute_offsets[i] = cur_offset;
 
+        if (repr_data->flattened_stables[i] == NULL) {
             /* Reference type. Needs marking. */
             repr_data->gc_obj_mark_offsets[repr_data->gc_obj_mark_offsets_count] = cur_offset;
             repr_data->gc_obj_mark_offsets_count++;
-
-            /* Increment by pointer size. */
-            cur_offset += sizeof(MVMObject *);
         }
         else {
-            /* Store position. */
             MVMSTable *cur_st = repr_data->flattened_stables[i];
-            MVMStorageSpec spec = cur_st->REPR->get_storage_spec(tc, cur_st);
 
             /* Set up flags for initialization and GC. */
             if (cur_st->REPR->initialize)
@@ -1032,21 +1102,15 @@ static void deserialize_repr_data(MVMThreadContext *tc, MVMSTable *st, MVMSerial
                 repr_data->gc_mark_slots[cur_gc_mark_slot++] = i;
             if (cur_st->REPR->gc_cleanup)
                 repr_data->gc_cleanup_slots[cur_gc_cleanup_slot++] = i;
-
-            if (cur_offset % spec.align) {
-                cur_offset += spec.align - cur_offset % spec.align;
-            }
-
-            repr_data->attribute_offsets[i] = cur_offset;
-
-            /* Increment by size reported by representation. */
-            cur_offset += spec.bits / 8;
         }
     }
+    layout_destroy(&layout);
     repr_data->initialize_slots[cur_initialize_slot] = -1;
     repr_data->gc_mark_slots[cur_gc_mark_slot] = -1;
     repr_data->gc_cleanup_slots[cur_gc_cleanup_slot] = -1;
 
+    build_name_index(tc, repr_data);
+
     st->REPR_data = repr_data;
 }
 
@@ -1292,6 +1356,29 @@ static MVMuint64 elems(MVMThreadContext *tc, MVMSTable *st, MVMObject *root, voi
     }
 }
 
+
+/* Picks the specialized op to get or bind a flattened native int or num
+ * attribute of the given type, going by its size, or returns 0 if there is
+ * none. P6int keeps sub-byte ints in a byte. */
+static MVMuint16 native_attr_op(MVMThreadContext *tc, MVMSTable *flat_st, MVMuint16 repr_id, MVMint32 bind) {
+    MVMStorageSpec flat_ss;
+    if (flat_st->REPR->ID != repr_id)
+        return 0;
+    flat_ss = flat_st->REPR->get_storage_spec(tc, flat_st);
+    if (repr_id == MVM_REPR_ID_P6int) {
+        switch (flat_ss.bits) {
+            case 64: return bind ? MVM_OP_sp_p6obind_i   : MVM_OP_sp_p6oget_i;
+            case 32: return bind ? MVM_OP_sp_p6obind_i32 : MVM_OP_sp_p6oget_i32;
+            case 16: return bind ? MVM_OP_sp_p6obind_i16 : MVM_OP_sp_p6oget_i16;
+            default: return bind ? MVM_OP_sp_p6obind_i8  : MVM_OP_sp_p6oget_i8;
+        }
+    }
+    switch (flat_ss.bits) {
+        case 64: return bind ? MVM_OP_sp_p6obind_n   : MVM_OP_sp_p6oget_n;
+        case 32: return bind ? MVM_OP_sp_p6obind_n32 : MVM_OP_sp_p6oget_n32;
+        default: return 0;
+    }
+}
 /* Bytecode specialization for this REPR. */
 static MVMString * spesh_attr_name(MVMThreadContext *tc, MVMSpeshGraph *g, MVMSpeshOperand o, MVMint32 indirect) {
     if (indirect) {
@@ -1361,11 +1448,11 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
         if (name && ch_facts->flags & MVM_SPESH_FACT_KNOWN_TYPE && ch_facts->type) {
             MVMint64 slot = try_get_slot(tc, repr_data, ch_facts->type, name);
             if (slot >= 0 && repr_data->flattened_stables[slot]) {
-                MVMSTable     *flat_st = repr_data->flattened_stables[slot];
-                MVMStorageSpec flat_ss = flat_st->REPR->get_storage_spec(tc, flat_st);
-                if (flat_st->REPR->ID == MVM_REPR_ID_P6int && flat_ss.bits == 64) {
+                MVMuint16 op = native_attr_op(tc, repr_data->flattened_stables[slot],
+                    MVM_REPR_ID_P6int, 0);
+                if (op) {
                     /*MVM_spesh_get_facts(tc, g, ins->operands[2])->usages--;*/
-                    ins->info = MVM_op_get_op(MVM_OP_sp_p6oget_i);
+                    ins->info = MVM_op_get_op(op);
                     ins->operands[2].lit_i16 = repr_data->attribute_offsets[slot];
                 }
             }
@@ -1380,11 +1467,11 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
             MVMint64 slot = try_get_slot(tc, repr_data, ch_facts->type,
                 MVM_spesh_get_string(tc, g, ins->operands[3]));
             if (slot >= 0 && repr_data->flattened_stables[slot]) {
-                MVMSTable     *flat_st = repr_data->flattened_stables[slot];
-                MVMStorageSpec flat_ss = flat_st->REPR->get_storage_spec(tc, flat_st);
-                if (flat_st->REPR->ID == MVM_REPR_ID_P6num && flat_ss.bits == 64) {
+                MVMuint16 op = native_attr_op(tc, repr_data->flattened_stables[slot],
+                    MVM_REPR_ID_P6num, 0);
+                if (op) {
                     /*MVM_spesh_get_facts(tc, g, ins->operands[2])->usages--;*/
-                    ins->info = MVM_op_get_op(MVM_OP_sp_p6oget_n);
+                    ins->info = MVM_op_get_op(op);
                     ins->operands[2].lit_i16 = repr_data->attribute_offsets[slot];
                 }
             }
@@ -1431,11 +1518,11 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
         if (name && ch_facts->flags & MVM_SPESH_FACT_KNOWN_TYPE && ch_facts->type) {
             MVMint64 slot = try_get_slot(tc, repr_data, ch_facts->type, name);
             if (slot >= 0 && repr_data->flattened_stables[slot]) {
-                MVMSTable     *flat_st = repr_data->flattened_stables[slot];
-                MVMStorageSpec flat_ss = flat_st->REPR->get_storage_spec(tc, flat_st);
-                if (flat_st->REPR->ID == MVM_REPR_ID_P6int && flat_ss.bits == 64) {
+                MVMuint16 op = native_attr_op(tc, repr_data->flattened_stables[slot],
+                    MVM_REPR_ID_P6int, 1);
+                if (op) {
                     MVM_spesh_get_facts(tc, g, ins->operands[1])->usages--;
-                    ins->info = MVM_op_get_op(MVM_OP_sp_p6obind_i);
+                    ins->info = MVM_op_get_op(op);
                     ins->operands[1].lit_i16 = repr_data->attribute_offsets[slot];
                     ins->operands[2] = ins->operands[3];
                 }
@@ -1450,11 +1537,11 @@ static void spesh(MVMThreadContext *tc, MVMSTable *st, MVMSpeshGraph *g, MVMSpes
         if (name && ch_facts->flags & MVM_SPESH_FACT_KNOWN_TYPE && ch_facts->type) {
             MVMint64 slot = try_get_slot(tc, repr_data, ch_facts->type, name);
             if (slot >= 0 && repr_data->flattened_stables[slot]) {
-                MVMSTable     *flat_st = repr_data->flattened_stables[slot];
-                MVMStorageSpec flat_ss = flat_st->REPR->get_storage_spec(tc, flat_st);
-                if (flat_st->REPR->ID == MVM_REPR_ID_P6num && flat_ss.bits == 64) {
+                MVMuint16 op = native_attr_op(tc, repr_data->flattened_stables[slot],
+                    MVM_REPR_ID_P6num, 1);
+                if (op) {
                     MVM_spesh_get_facts(tc, g, ins->operands[1])->usages--;
-                    ins->info = MVM_op_get_op(MVM_OP_sp_p6obind_n);
+                    ins->info = MVM_op_get_op(op);
                     ins->operands[1].lit_i16 = repr_data->attribute_offsets[slot];
                     ins->operands[2] = ins->operands[3];
                 }
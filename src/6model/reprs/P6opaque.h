@@ -2,8 +2,9 @@
  * follows on from this depends on the declaration. For object attributes, it will
  * be a pointer size and point to another MVMObject. For native integers and
  * numbers, it will be the appropriate sized piece of memory to store them
- * right there in the object. Note that P6opaque does not do packed storage, so
- * an int2 gets as much space as an int. */
+ * right there in the object, with small ones filling in gaps left by the
+ * alignment of earlier attributes where they can. Ints of under 8 bits still
+ * get a whole byte. */
 struct MVMP6opaqueBody {
     /* If we get mixed into, we may change size. If so, we can't really resize
      * the object, so instead we hang its post-resize form off this pointer.
@@ -17,9 +18,8 @@ struct MVMP6opaque {
 };
 
 /* This is used in the name to slot mapping. Indicates the class key that
- * we have the mappings for, followed by arrays of names and slots. (Yeah,
- * could use a hash, but much code will resolve these statically to the
- * slots). */
+ * we have the mappings for, followed by arrays of names and slots. Lookups
+ * go through the name index below rather than scanning these. */
 struct MVMP6opaqueNameMap {
     MVMObject  *class_key;
     MVMString **names;
@@ -27,6 +27,16 @@ struct MVMP6opaqueNameMap {
     MVMuint32   num_attrs;
 };
 
+/* An entry in the index from class key and name to slot, which is an open
+ * addressing table over all of the name map entries, hashed by name. The
+ * entry points back into the name map, so holds no references itself. */
+#define MVM_P6OPAQUE_NAME_INDEX_EMPTY 0xFFFF
+struct MVMP6opaqueNameIndexEntry {
+    MVMuint32 hash_code;
+    MVMuint16 map_idx;
+    MVMuint16 attr_idx;
+};
+
 /* This is used in boxed type mappings. */
 struct MVMP6opaqueBoxedTypeMap {
     MVMuint32 repr_id;
@@ -84,6 +94,12 @@ struct MVMP6opaqueREPRData {
      * up in the offset table). Uses a final null entry as a sentinel. */
     MVMP6opaqueNameMap *name_to_index_mapping;
 
+    /* Index over the name map for attribute lookups; NULL if there are no
+     * attributes. The number of entries is a power of two, one more than
+     * the mask. */
+    MVMP6opaqueNameIndexEntry *name_index;
+    MVMuint32 name_index_mask;
+
     /* Slots holding flattened objects that need another REPR to initialize
      * them; terminated with -1. */
     MVMint16 *initialize_slots;
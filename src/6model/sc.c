@@ -13,12 +13,11 @@ MVMObject * MVM_sc_create(MVMThreadContext *tc, MVMString *handle) {
         MVMROOT(tc, sc, {
             /* Add to weak lookup hash. */
             uv_mutex_lock(&tc->instance->mutex_sc_weakhash);
-            MVM_string_flatten(tc, handle);
             MVM_HASH_GET(tc, tc->instance->sc_weakhash, handle, scb);
             if (!scb) {
                 sc->body = scb = calloc(1, sizeof(MVMSerializationContextBody));
                 MVM_ASSIGN_REF(tc, &(sc->common.header), scb->handle, handle);
-                MVM_HASH_BIND(tc, tc->instance->sc_weakhash, handle, scb);
+                MVM_HASH_BIND(tc, tc->instance->sc_weakhash, handle, scb, handle);
                 /* Calling repr_init will allocate, BUT if it does so, and we
                  * get unlucky, the GC will try to acquire mutex_sc_weakhash.
                  * This deadlocks. Thus, we force allocation in gen2, which
@@ -284,7 +283,6 @@ MVMObject * MVM_sc_get_code(MVMThreadContext *tc, MVMSerializationContext *sc, M
 /* Resolves an SC handle using the SC weakhash. */
 MVMSerializationContext * MVM_sc_find_by_handle(MVMThreadContext *tc, MVMString *handle) {
     MVMSerializationContextBody *scb;
-    MVM_string_flatten(tc, handle);
     uv_mutex_lock(&tc->instance->mutex_sc_weakhash);
     MVM_HASH_GET(tc, tc->instance->sc_weakhash, handle, scb);
     uv_mutex_unlock(&tc->instance->mutex_sc_weakhash);
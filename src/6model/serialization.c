@@ -1246,10 +1246,21 @@ static void fail_deserialize(MVMThreadContext *tc, MVMSerializationReader *reade
     va_end(args);
 }
 
-/* Reads the item from the string heap at the specified index. */
+/* Reads the item from the string heap at the specified index. The first
+ * read of each interns it, and if an equal string was already interned,
+ * puts that in its place in the heap, so later reads needn't go near the
+ * intern table and its lock. */
 static MVMString * read_string_from_heap(MVMThreadContext *tc, MVMSerializationReader *reader, MVMuint32 idx) {
-    if (idx < MVM_repr_elems(tc, reader->root.string_heap))
-        return MVM_repr_at_pos_s(tc, reader->root.string_heap, idx);
+    if (idx < MVM_repr_elems(tc, reader->root.string_heap)) {
+        MVMString *s = MVM_repr_at_pos_s(tc, reader->root.string_heap, idx);
+        if (s && !s->body.interned) {
+            MVMString *canonical = MVM_string_intern(tc, s);
+            if (canonical != s)
+                MVM_repr_bind_pos_s(tc, reader->root.string_heap, idx, canonical);
+            s = canonical;
+        }
+        return s;
+    }
     else
         fail_deserialize(tc, reader,
             "Attempt to read past end of string heap (index %d)", idx);
@@ -2043,8 +2054,10 @@ static void deserialize_stable(MVMThreadContext *tc, MVMSerializationReader *rea
     }
 
     /* If the REPR has a function to deserialize representation data, call it. */
-    if (st->REPR->deserialize_repr_data)
+    if (st->REPR->deserialize_repr_data) {
         st->REPR->deserialize_repr_data(tc, st, reader);
+        st->repr_data_version++;
+    }
 
     /* Restore original read positions. */
     reader->stables_data_offset = orig_stables_data_offset;
@@ -736,9 +736,10 @@ static void flatten_args(MVMThreadContext *tc, MVMArgProcContext *ctx) {
 
         if (arg_info.arg.o && REPR(arg_info.arg.o)->ID == MVM_REPR_ID_MVMHash) {
             MVMHashBody *body = &((MVMHash *)arg_info.arg.o)->body;
-            MVMHashEntry *current, *tmp;
+            MVMuint32 i;
 
-            HASH_ITER(hash_handle, body->hash_head, current, tmp) {
+            for (i = MVM_hash_next_live(body, 0); i < body->num_entries; i = MVM_hash_next_live(body, i + 1)) {
+                MVMHashEntry *current = &(body->entries[i]);
 
                 if (new_arg_pos + 1 >= new_args_size) {
                     new_args = realloc(new_args, (new_args_size *= 2) * sizeof(MVMRegister));
@@ -285,7 +285,8 @@ static MVMString ** deserialize_strings(MVMThreadContext *tc, MVMCompUnit *cu, R
         /* Ensure we can read in the string of this size, and decode
          * it if so. */
         ensure_can_read(tc, cu, rs, pos, ss);
-        MVM_ASSIGN_REF(tc, &(cu->common.header), strings[i], MVM_string_utf8_decode(tc, tc->instance->VMString, pos, ss));
+        MVM_ASSIGN_REF(tc, &(cu->common.header), strings[i], MVM_string_intern(tc,
+            MVM_string_utf8_decode(tc, tc->instance->VMString, pos, ss)));
         pos += ss;
 
         /* Add alignment. */
@@ -328,7 +329,6 @@ static void deserialize_sc_deps(MVMThreadContext *tc, MVMCompUnit *cu, ReaderSta
 
         /* See if we can resolve it. */
         uv_mutex_lock(&tc->instance->mutex_sc_weakhash);
-        MVM_string_flatten(tc, handle);
         MVM_HASH_GET(tc, tc->instance->sc_weakhash, handle, scb);
         if (scb && scb->sc) {
             cu_body->scs_to_resolve[i] = NULL;
@@ -338,7 +338,7 @@ static void deserialize_sc_deps(MVMThreadContext *tc, MVMCompUnit *cu, ReaderSta
             if (!scb) {
                 scb = calloc(1, sizeof(MVMSerializationContextBody));
                 scb->handle = handle;
-                MVM_HASH_BIND(tc, tc->instance->sc_weakhash, handle, scb);
+                MVM_HASH_BIND(tc, tc->instance->sc_weakhash, handle, scb, handle);
                 MVM_sc_add_all_scs_entry(tc, scb);
             }
             cu_body->scs_to_resolve[i] = scb;
@@ -667,8 +667,7 @@ void MVM_bytecode_finish_frame(MVMThreadContext *tc, MVMCompUnit *cu,
             entry->value = j;
 
             sf->body.lexical_types[j] = read_int16(pos, 6 * j);
-            MVM_string_flatten(tc, name);
-            MVM_HASH_BIND(tc, sf->body.lexical_names, name, entry)
+            MVM_HASH_BIND(tc, sf->body.lexical_names, name, entry, key);
         }
         pos += 6 * sf->body.num_lexicals;
     }
@@ -17,7 +17,6 @@ int MVM_ext_load(MVMThreadContext *tc, MVMString *lib, MVMString *ext) {
 
     uv_mutex_lock(&tc->instance->mutex_ext_registry);
 
-    MVM_string_flatten(tc, name);
     MVM_HASH_GET(tc, tc->instance->ext_registry, name, entry);
 
     /* Extension already loaded. */
@@ -39,7 +38,7 @@ int MVM_ext_load(MVMThreadContext *tc, MVMString *lib, MVMString *ext) {
     entry->name = name;
 
     MVM_gc_root_add_permanent(tc, (MVMCollectable **)&entry->name);
-    MVM_HASH_BIND(tc, tc->instance->ext_registry, name, entry);
+    MVM_HASH_BIND(tc, tc->instance->ext_registry, name, entry, name);
 
     uv_mutex_unlock(&tc->instance->mutex_ext_registry);
 
@@ -59,7 +58,6 @@ int MVM_ext_register_extop(MVMThreadContext *tc, const char *cname,
 
     uv_mutex_lock(&tc->instance->mutex_extop_registry);
 
-    MVM_string_flatten(tc, name);
     MVM_HASH_GET(tc, tc->instance->extop_registry, name, entry);
 
     /* Op already registered, so just verify its signature. */
@@ -162,7 +160,7 @@ int MVM_ext_register_extop(MVMThreadContext *tc, const char *cname,
     entry->no_jit   = flags & MVM_EXTOP_NO_JIT;
 
     MVM_gc_root_add_permanent(tc, (MVMCollectable **)&entry->name);
-    MVM_HASH_BIND(tc, tc->instance->extop_registry, name, entry);
+    MVM_HASH_BIND(tc, tc->instance->extop_registry, name, entry, name);
 
     uv_mutex_unlock(&tc->instance->mutex_extop_registry);
 
@@ -179,7 +177,6 @@ const MVMOpInfo * MVM_ext_resolve_extop_record(MVMThreadContext *tc,
 
     uv_mutex_lock(&tc->instance->mutex_extop_registry);
 
-    MVM_string_flatten(tc, record->name);
     MVM_HASH_GET(tc, tc->instance->extop_registry, record->name, entry);
 
     if (!entry) {
@@ -1,11 +1,14 @@
 #include "moar.h"
+#include "platform/mmap.h"
 
 /* The fixed size allocator provides a thread-safe mechanism for getting and
  * releasing fixed-size chunks of memory. Requests larger blocks from the
  * operating system, and then allocates out of them. Can certainly be further
  * improved. The free list works like a stack, so you get the most recently
  * freed piece of memory of a given size, which should give good cache
- * behavior. */
+ * behavior. Each thread keeps its own short free list per size class, and
+ * only goes to the shared one (in batches) when that runs dry or gets too
+ * long, so most allocations and frees need no atomic operations. */
 
 /* Turn this on to switch to a mode where we debug by size. */
 #define FSA_SIZE_DEBUG 0
@@ -37,6 +40,15 @@ static MVMuint32 bin_for(size_t bytes) {
     return bin;
 }
 
+/* Gets memory for a page straight from the operating system, so that it can
+ * be handed back again if the page ever becomes entirely free. */
+static char * alloc_page_memory(MVMuint32 page_size) {
+    char *page = MVM_platform_alloc_pages(page_size, MVM_PAGE_READ | MVM_PAGE_WRITE);
+    if (!page)
+        MVM_panic(MVM_exitcode_gcalloc, "Failed to allocate FSA page of %u bytes", page_size);
+    return page;
+}
+
 /* Sets up a size class bin in the second generation. */
 static void setup_bin(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     /* Work out page size we want. */
@@ -45,7 +57,7 @@ static void setup_bin(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     /* We'll just allocate a single page to start off with. */
     al->size_classes[bin].num_pages = 1;
     al->size_classes[bin].pages     = malloc(sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[0]  = malloc(page_size);
+    al->size_classes[bin].pages[0]  = alloc_page_memory(page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[0];
@@ -62,7 +74,7 @@ static void add_page(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     al->size_classes[bin].num_pages++;
     al->size_classes[bin].pages = realloc(al->size_classes[bin].pages,
         sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[cur_page] = malloc(page_size);
+    al->size_classes[bin].pages[cur_page] = alloc_page_memory(page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[cur_page];
@@ -72,9 +84,94 @@ static void add_page(MVMFixedSizeAlloc *al, MVMuint32 bin) {
     al->size_classes[bin].cur_page = cur_page;
 }
 
-/* Allocates a piece of memory of the specified size, using the FSA. */
+/* Takes a batch of slots from the global free list of a bin into the thread's
+ * own free list, which must be empty. Only ever done with the lock held (or
+ * when single-threaded), so the only thing that can race with us is a thread
+ * giving slots back; that only ever changes the head. */
+static MVMuint32 take_batch(MVMFixedSizeAllocSizeClass *bin_ptr, MVMFixedSizeAllocThreadSizeClass *tbin_ptr) {
+    MVMFixedSizeAllocFreeListEntry *head, *last;
+    MVMuint32 items;
+    do {
+        head = bin_ptr->free_list;
+        if (!head)
+            return 0;
+        last  = head;
+        items = 1;
+        while (items < MVM_FSA_THREAD_BATCH && last->next) {
+            last = (MVMFixedSizeAllocFreeListEntry *)last->next;
+            items++;
+        }
+    } while (!MVM_trycas(&(bin_ptr->free_list), head, last->next));
+    MVM_add(&(bin_ptr->free_items), -(AO_t)items);
+    last->next         = NULL;
+    tbin_ptr->free_list = head;
+    tbin_ptr->items     = items;
+    return items;
+}
+
+/* Gives the slots on a thread's free list for a bin after the first keep of
+ * them back to the global free list. */
+static void give_back(MVMFixedSizeAllocSizeClass *bin_ptr, MVMFixedSizeAllocThreadSizeClass *tbin_ptr, MVMuint32 keep) {
+    MVMFixedSizeAllocFreeListEntry *head, *last, *orig;
+    MVMuint32 given, i;
+    if (tbin_ptr->items <= keep)
+        return;
+    given = tbin_ptr->items - keep;
+
+    /* Split the list, keeping the most recently freed slots. */
+    if (keep) {
+        MVMFixedSizeAllocFreeListEntry *split = tbin_ptr->free_list;
+        for (i = 1; i < keep; i++)
+            split = (MVMFixedSizeAllocFreeListEntry *)split->next;
+        head = (MVMFixedSizeAllocFreeListEntry *)split->next;
+        split->next = NULL;
+    }
+    else {
+        head = tbin_ptr->free_list;
+        tbin_ptr->free_list = NULL;
+    }
+    tbin_ptr->items = keep;
+
+    /* Push the rest on to the global free list in one go. */
+    last = head;
+    while (last->next)
+        last = (MVMFixedSizeAllocFreeListEntry *)last->next;
+    do {
+        orig = bin_ptr->free_list;
+        last->next = orig;
+    } while (!MVM_trycas(&(bin_ptr->free_list), orig, head));
+    MVM_add(&(bin_ptr->free_items), given);
+}
+
+/* Sets up a thread's cache of free slots. */
+void MVM_fixed_size_create_thread(MVMThreadContext *tc) {
+    tc->thread_fsa = malloc(sizeof(MVMFixedSizeAllocThread));
+    tc->thread_fsa->size_classes = calloc(MVM_FSA_BINS, sizeof(MVMFixedSizeAllocThreadSizeClass));
+}
+
+/* Gives all of a thread's cached free slots back to the global free lists. */
+void MVM_fixed_size_flush_thread(MVMThreadContext *tc) {
+    MVMFixedSizeAlloc *al = tc->instance->fsa;
+    MVMuint32 bin;
+    for (bin = 0; bin < MVM_FSA_BINS; bin++)
+        give_back(&(al->size_classes[bin]), &(tc->thread_fsa->size_classes[bin]), 0);
+}
+
+/* Flushes and frees a thread's cache of free slots. */
+void MVM_fixed_size_destroy_thread(MVMThreadContext *tc) {
+    MVM_fixed_size_flush_thread(tc);
+    free(tc->thread_fsa->size_classes);
+    free(tc->thread_fsa);
+    tc->thread_fsa = NULL;
+}
+
+/* Refills the thread's free list for a bin and allocates from it. We take a
+ * batch from the global free list if we can, and otherwise carve out a batch
+ * of fresh slots from the current page. */
 static void * alloc_slow_path(MVMThreadContext *tc, MVMFixedSizeAlloc *al, MVMuint32 bin) {
-    void *result;
+    MVMFixedSizeAllocSizeClass       *bin_ptr  = &(al->size_classes[bin]);
+    MVMFixedSizeAllocThreadSizeClass *tbin_ptr = &(tc->thread_fsa->size_classes[bin]);
+    MVMFixedSizeAllocFreeListEntry   *result;
 
     /* Lock, unless single-threaded. */
     MVMint32 lock = tc->instance->next_user_thread_id != 2;
@@ -82,22 +179,34 @@ static void * alloc_slow_path(MVMThreadContext *tc, MVMFixedSizeAlloc *al, MVMui
         uv_mutex_lock(&(al->complex_alloc_mutex));
 
     /* If we've no pages yet, never encountered this bin; set it up. */
-    if (al->size_classes[bin].pages == NULL)
+    if (bin_ptr->pages == NULL)
         setup_bin(al, bin);
 
-    /* If we're at the page limit, add a new page. */
-    if (al->size_classes[bin].alloc_pos == al->size_classes[bin].alloc_limit)
-        add_page(al, bin);
+    if (!take_batch(bin_ptr, tbin_ptr)) {
+        MVMuint32 obj_size = (bin + 1) << MVM_FSA_BIN_BITS;
 
-    /* Now we can allocate. */
-    result = (void *)al->size_classes[bin].alloc_pos;
-    al->size_classes[bin].alloc_pos += (bin + 1) << MVM_FSA_BIN_BITS;
+        /* If we're at the page limit, add a new page. */
+        if (bin_ptr->alloc_pos == bin_ptr->alloc_limit)
+            add_page(al, bin);
+
+        /* Now we can allocate. */
+        while (tbin_ptr->items < MVM_FSA_THREAD_BATCH && bin_ptr->alloc_pos < bin_ptr->alloc_limit) {
+            MVMFixedSizeAllocFreeListEntry *fle = (MVMFixedSizeAllocFreeListEntry *)bin_ptr->alloc_pos;
+            fle->next = tbin_ptr->free_list;
+            tbin_ptr->free_list = fle;
+            tbin_ptr->items++;
+            bin_ptr->alloc_pos += obj_size;
+        }
+    }
 
     /* Unlock if we locked. */
     if (lock)
         uv_mutex_unlock(&(al->complex_alloc_mutex));
 
-    return result;
+    result = tbin_ptr->free_list;
+    tbin_ptr->free_list = (MVMFixedSizeAllocFreeListEntry *)result->next;
+    tbin_ptr->items--;
+    return (void *)result;
 }
 void * MVM_fixed_size_alloc(MVMThreadContext *tc, MVMFixedSizeAlloc *al, size_t bytes) {
 #if FSA_SIZE_DEBUG
@@ -107,29 +216,16 @@ void * MVM_fixed_size_alloc(MVMThreadContext *tc, MVMFixedSizeAlloc *al, size_t
 #else
     MVMuint32 bin = bin_for(bytes);
     if (bin < MVM_FSA_BINS) {
-        char *allocd;
-
-        /* Try and take from the free list (fast path). */
-        MVMFixedSizeAllocSizeClass     *bin_ptr = &(al->size_classes[bin]);
-        MVMFixedSizeAllocFreeListEntry *fle;
-        if (tc->instance->next_user_thread_id != 2) {
-            /* Multi-threaded; race for it. */
-            do {
-                fle = bin_ptr->free_list;
-                if (!fle)
-                    break;
-            } while (!MVM_trycas(&(bin_ptr->free_list), fle, fle->next));
-        }
-        else {
-            /* Single-threaded; just take it. */
-            fle = bin_ptr->free_list;
-            if (fle)
-                bin_ptr->free_list = fle->next;
-        }
-        if (fle)
+        /* Try and take from the thread's free list (fast path). */
+        MVMFixedSizeAllocThreadSizeClass *tbin_ptr = &(tc->thread_fsa->size_classes[bin]);
+        MVMFixedSizeAllocFreeListEntry   *fle      = tbin_ptr->free_list;
+        if (fle) {
+            tbin_ptr->free_list = (MVMFixedSizeAllocFreeListEntry *)fle->next;
+            tbin_ptr->items--;
             return (void *)fle;
+        }
 
-        /* Failed to take from free list; slow path with the lock. */
+        /* Nothing there; slow path to refill it. */
         return alloc_slow_path(tc, al, bin);
     }
     else {
@@ -156,22 +252,14 @@ void MVM_fixed_size_free(MVMThreadContext *tc, MVMFixedSizeAlloc *al, size_t byt
 #else
     MVMuint32 bin = bin_for(bytes);
     if (bin < MVM_FSA_BINS) {
-        /* Came from a bin; put into free list. */
-        MVMFixedSizeAllocSizeClass     *bin_ptr = &(al->size_classes[bin]);
-        MVMFixedSizeAllocFreeListEntry *to_add  = (MVMFixedSizeAllocFreeListEntry *)to_free;
-        MVMFixedSizeAllocFreeListEntry *orig;
-        if (tc->instance->next_user_thread_id != 2) {
-            /* Multi-threaded; race to add it. */
-            do {
-                orig = bin_ptr->free_list;
-                to_add->next = orig;
-            } while (!MVM_trycas(&(bin_ptr->free_list), orig, to_add));
-        }
-        else {
-            /* Single-threaded; just add it. */
-            to_add->next       = bin_ptr->free_list;
-            bin_ptr->free_list = to_add;
-        }
+        /* Came from a bin; put into the thread's free list, giving some back
+         * to the global one if it's getting long. */
+        MVMFixedSizeAllocThreadSizeClass *tbin_ptr = &(tc->thread_fsa->size_classes[bin]);
+        MVMFixedSizeAllocFreeListEntry   *to_add   = (MVMFixedSizeAllocFreeListEntry *)to_free;
+        to_add->next = tbin_ptr->free_list;
+        tbin_ptr->free_list = to_add;
+        if (++tbin_ptr->items > MVM_FSA_THREAD_MAX)
+            give_back(&(al->size_classes[bin]), tbin_ptr, MVM_FSA_THREAD_MAX - MVM_FSA_THREAD_BATCH);
     }
     else {
         /* Was malloc'd due to being oversize, so just free it. */
@@ -179,3 +267,146 @@ void MVM_fixed_size_free(MVMThreadContext *tc, MVMFixedSizeAlloc *al, size_t byt
     }
 #endif
 }
+
+#if !FSA_SIZE_DEBUG
+/* Used to sort a bin's pages by address, so we can find which one a free
+ * list entry belongs to. */
+typedef struct {
+    char      *start;
+    MVMuint32  page;
+} MVMFixedSizeAllocPageRef;
+static int page_ref_cmp(const void *a, const void *b) {
+    char *sa = ((const MVMFixedSizeAllocPageRef *)a)->start;
+    char *sb = ((const MVMFixedSizeAllocPageRef *)b)->start;
+    return sa < sb ? -1 : sa > sb ? 1 : 0;
+}
+static MVMuint32 page_for(MVMFixedSizeAllocPageRef *refs, MVMuint32 num_pages, char *addr) {
+    MVMuint32 lo = 0, hi = num_pages;
+    while (hi - lo > 1) {
+        MVMuint32 mid = (lo + hi) / 2;
+        if (refs[mid].start <= addr)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return refs[lo].page;
+}
+
+/* Goes through one bin, counting the free slots in each page. Pages that
+ * are entirely free, other than the one we are still bump-allocating in, are
+ * given back to the OS. The rest of the free list is rebuilt so that the
+ * fullest pages come first, meaning allocation fills them up and gives the
+ * sparse ones a chance to empty out. */
+static void release_bin_pages(MVMThreadContext *tc, MVMFixedSizeAlloc *al, MVMuint32 bin) {
+    MVMFixedSizeAllocSizeClass      *bin_ptr   = &(al->size_classes[bin]);
+    MVMuint32                        page_size = MVM_FSA_PAGE_ITEMS * ((bin + 1) << MVM_FSA_BIN_BITS);
+    MVMuint32                        num_pages = bin_ptr->num_pages;
+    MVMFixedSizeAllocFreeListEntry  *fle, *next, **tail;
+    MVMFixedSizeAllocFreeListEntry **page_heads;
+    MVMFixedSizeAllocPageRef        *refs;
+    MVMuint32                       *free_counts, *order;
+    MVMuint32                        i, j, kept, cur_page, free_items;
+
+    if (!bin_ptr->free_list)
+        return;
+
+    /* Sort out which page each free slot is in. */
+    refs        = malloc(num_pages * sizeof(MVMFixedSizeAllocPageRef));
+    page_heads  = calloc(num_pages, sizeof(MVMFixedSizeAllocFreeListEntry *));
+    free_counts = calloc(num_pages, sizeof(MVMuint32));
+    order       = malloc(num_pages * sizeof(MVMuint32));
+    for (i = 0; i < num_pages; i++) {
+        refs[i].start = bin_ptr->pages[i];
+        refs[i].page  = i;
+    }
+    qsort(refs, num_pages, sizeof(MVMFixedSizeAllocPageRef), page_ref_cmp);
+    for (fle = bin_ptr->free_list; fle; fle = next) {
+        MVMuint32 page = page_for(refs, num_pages, (char *)fle);
+        next = fle->next;
+        fle->next = page_heads[page];
+        page_heads[page] = fle;
+        free_counts[page]++;
+    }
+
+    /* Release the empty pages, and order the others fullest first. */
+    kept       = 0;
+    free_items = 0;
+    for (i = 0; i < num_pages; i++) {
+        if (free_counts[i] == MVM_FSA_PAGE_ITEMS && i != bin_ptr->cur_page) {
+            MVM_platform_free_pages(bin_ptr->pages[i], page_size);
+            bin_ptr->pages[i] = NULL;
+            MVM_add(&tc->instance->gc_released_bytes, page_size);
+            continue;
+        }
+        free_items += free_counts[i];
+        j = kept++;
+        while (j > 0 && free_counts[order[j - 1]] > free_counts[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    /* Chain the pages' free slots back together in that order. */
+    tail = &(bin_ptr->free_list);
+    for (i = 0; i < kept; i++) {
+        *tail = page_heads[order[i]];
+        while (*tail)
+            tail = (MVMFixedSizeAllocFreeListEntry **)&((*tail)->next);
+    }
+
+    /* Close up the gaps left in the pages list. */
+    cur_page = 0;
+    for (i = 0, j = 0; i < num_pages; i++) {
+        if (!bin_ptr->pages[i])
+            continue;
+        if (i == bin_ptr->cur_page)
+            cur_page = j;
+        bin_ptr->pages[j++] = bin_ptr->pages[i];
+    }
+    bin_ptr->num_pages  = j;
+    bin_ptr->cur_page   = cur_page;
+    bin_ptr->free_items = free_items;
+
+    free(refs);
+    free(page_heads);
+    free(free_counts);
+    free(order);
+}
+#endif
+
+/* Whether a bin has enough free slots that it is worth looking for empty
+ * pages in it. */
+static MVMuint32 worth_releasing(MVMFixedSizeAlloc *al, MVMuint32 bin) {
+    return al->size_classes[bin].pages
+        && al->size_classes[bin].free_items >= MVM_FSA_RELEASE_PAGES * MVM_FSA_PAGE_ITEMS;
+}
+
+/* Gives pages that are entirely free back to the OS, and orders the free
+ * lists to favor filling up the fullest pages. This is done during a full
+ * collection, while all other threads are stopped, so we can first take
+ * back the free slots that each of them has cached. Since that costs the
+ * threads their caches and adds to the pause, we only do it when some bin
+ * has a good few pages' worth of slots on its free list, and then only for
+ * such bins. */
+void MVM_fixed_size_release_free_pages(MVMThreadContext *tc, MVMFixedSizeAlloc *al) {
+#if !FSA_SIZE_DEBUG
+    MVMThread *cur_thread;
+    MVMuint32 bin;
+    for (bin = 0; bin < MVM_FSA_BINS; bin++)
+        if (worth_releasing(al, bin))
+            break;
+    if (bin == MVM_FSA_BINS)
+        return;
+
+    cur_thread = (MVMThread *)MVM_load(&tc->instance->threads);
+    while (cur_thread) {
+        if (cur_thread->body.tc)
+            MVM_fixed_size_flush_thread(cur_thread->body.tc);
+        cur_thread = cur_thread->body.next;
+    }
+    for (bin = 0; bin < MVM_FSA_BINS; bin++)
+        if (worth_releasing(al, bin))
+            release_bin_pages(tc, al, bin);
+#endif
+}
@@ -23,6 +23,10 @@ struct MVMFixedSizeAllocSizeClass {
     /* Head of the free list. */
     MVMFixedSizeAllocFreeListEntry *free_list;
 
+    /* Roughly how many slots are on the free list; only exact while the
+     * world is stopped. */
+    AO_t free_items;
+
     /* The current allocation position if we've nothing on the
      * free list. */
     char *alloc_pos;
@@ -38,6 +42,19 @@ struct MVMFixedSizeAllocSizeClass {
     MVMuint32 num_pages;
 };
 
+/* Each thread keeps a small cache of free slots for each size class, so
+ * most allocations and frees need no synchronization at all. */
+struct MVMFixedSizeAllocThread {
+    MVMFixedSizeAllocThreadSizeClass *size_classes;
+};
+struct MVMFixedSizeAllocThreadSizeClass {
+    /* Head of the thread's free list for this size class. */
+    MVMFixedSizeAllocFreeListEntry *free_list;
+
+    /* How many items are on it. */
+    MVMuint32 items;
+};
+
 /* The number of bits we discard from the requested size when binning
  * the allocation request into a size class. For example, if this is
  * 3 bits then:
@@ -55,11 +72,25 @@ struct MVMFixedSizeAllocSizeClass {
 /* Number of bins in the FSA. Beyond this, we just degrade to malloc/free. */
 #define MVM_FSA_BINS       128
 
-/* The number of items that go into each page. */
-#define MVM_FSA_PAGE_ITEMS 256
+/* The number of items that go into each page. This makes every page a whole
+ * number of 4KB OS pages, so empty ones can be given back to the OS. */
+#define MVM_FSA_PAGE_ITEMS 512
+
+/* The number of free slots a thread takes from or gives back to the global
+ * free list at a time, and the most it will hold on to for a size class. */
+#define MVM_FSA_THREAD_BATCH 32
+#define MVM_FSA_THREAD_MAX   64
+
+/* How many pages' worth of slots must be on a size class's free list before
+ * a full collection bothers looking for empty pages to give back. */
+#define MVM_FSA_RELEASE_PAGES 4
 
 /* Functions. */
 MVMFixedSizeAlloc * MVM_fixed_size_create(MVMThreadContext *tc);
+void MVM_fixed_size_create_thread(MVMThreadContext *tc);
+void MVM_fixed_size_destroy_thread(MVMThreadContext *tc);
+void MVM_fixed_size_flush_thread(MVMThreadContext *tc);
 void * MVM_fixed_size_alloc(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa, size_t bytes);
 void * MVM_fixed_size_alloc_zeroed(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa, size_t bytes);
 void MVM_fixed_size_free(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa, size_t bytes, void *free);
+void MVM_fixed_size_release_free_pages(MVMThreadContext *tc, MVMFixedSizeAlloc *fsa);
@@ -990,14 +990,13 @@ MVMObject * MVM_frame_vivify_lexical(MVMThreadContext *tc, MVMFrame *f, MVMuint1
  * if it does not exist. Incorrect type always throws. */
 MVMRegister * MVM_frame_find_lexical_by_name(MVMThreadContext *tc, MVMString *name, MVMuint16 type) {
     MVMFrame *cur_frame = tc->cur_frame;
-    MVM_string_flatten(tc, name);
     while (cur_frame != NULL) {
         MVMLexicalRegistry *lexical_names = cur_frame->static_info->body.lexical_names;
         if (lexical_names) {
             /* Indexes were formerly stored off-by-one to avoid semi-predicate issue. */
             MVMLexicalRegistry *entry;
 
-            MVM_HASH_GET(tc, lexical_names, name, entry)
+            MVM_HASH_GET(tc, lexical_names, name, entry);
 
             if (entry) {
                 if (cur_frame->static_info->body.lexical_types[entry->value] == type) {
@@ -1034,14 +1033,13 @@ MVMObject * MVM_frame_find_lexical_by_name_outer(MVMThreadContext *tc, MVMString
 /* Looks up the address of the lexical with the specified name, starting with
  * the specified frame. Only works if it's an object lexical.  */
 MVMRegister * MVM_frame_find_lexical_by_name_rel(MVMThreadContext *tc, MVMString *name, MVMFrame *cur_frame) {
-    MVM_string_flatten(tc, name);
     while (cur_frame != NULL) {
         MVMLexicalRegistry *lexical_names = cur_frame->static_info->body.lexical_names;
         if (lexical_names) {
             /* Indexes were formerly stored off-by-one to avoid semi-predicate issue. */
             MVMLexicalRegistry *entry;
 
-            MVM_HASH_GET(tc, lexical_names, name, entry)
+            MVM_HASH_GET(tc, lexical_names, name, entry);
 
             if (entry) {
                 if (cur_frame->static_info->body.lexical_types[entry->value] == MVM_reg_obj) {
@@ -1065,7 +1063,6 @@ MVMRegister * MVM_frame_find_lexical_by_name_rel(MVMThreadContext *tc, MVMString
 /* Looks up the address of the lexical with the specified name, starting with
  * the specified frame. It checks all outer frames of the caller frame chain.  */
 MVMRegister * MVM_frame_find_lexical_by_name_rel_caller(MVMThreadContext *tc, MVMString *name, MVMFrame *cur_caller_frame) {
-    MVM_string_flatten(tc, name);
     while (cur_caller_frame != NULL) {
         MVMFrame *cur_frame = cur_caller_frame;
         while (cur_frame != NULL) {
@@ -1074,7 +1071,7 @@ MVMRegister * MVM_frame_find_lexical_by_name_rel_caller(MVMThreadContext *tc, MV
                 /* Indexes were formerly stored off-by-one to avoid semi-predicate issue. */
                 MVMLexicalRegistry *entry;
 
-                MVM_HASH_GET(tc, lexical_names, name, entry)
+                MVM_HASH_GET(tc, lexical_names, name, entry);
 
                 if (entry) {
                     if (cur_frame->static_info->body.lexical_types[entry->value] == MVM_reg_obj) {
@@ -1140,7 +1137,6 @@ MVMRegister * MVM_frame_find_contextual_by_name(MVMThreadContext *tc, MVMString
         MVM_exception_throw_adhoc(tc, "Contextual name cannot be null");
     if (dlog)
         c_name = MVM_string_utf8_encode_C_string(tc, name);
-    MVM_string_flatten(tc, name);
     while (cur_frame != NULL) {
         MVMLexicalRegistry *lexical_names;
         MVMSpeshCandidate  *cand     = cur_frame->spesh_cand;
@@ -1235,7 +1231,7 @@ MVMRegister * MVM_frame_find_contextual_by_name(MVMThreadContext *tc, MVMString
         /* Now look in the frame itself. */
         if (lexical_names = cur_frame->static_info->body.lexical_names) {
             MVMLexicalRegistry *entry;
-            MVM_HASH_GET(tc, lexical_names, name, entry)
+            MVM_HASH_GET(tc, lexical_names, name, entry);
             if (entry) {
                 MVMRegister *result = &cur_frame->env[entry->value];
                 *type = cur_frame->static_info->body.lexical_types[entry->value];
@@ -1348,8 +1344,7 @@ MVMRegister * MVM_frame_lexical(MVMThreadContext *tc, MVMFrame *f, MVMString *na
     MVMLexicalRegistry *lexical_names = f->static_info->body.lexical_names;
     if (lexical_names) {
         MVMLexicalRegistry *entry;
-        MVM_string_flatten(tc, name);
-        MVM_HASH_GET(tc, lexical_names, name, entry)
+        MVM_HASH_GET(tc, lexical_names, name, entry);
         if (entry)
             return &f->env[entry->value];
     }
@@ -1362,8 +1357,7 @@ MVMRegister * MVM_frame_try_get_lexical(MVMThreadContext *tc, MVMFrame *f, MVMSt
     MVMLexicalRegistry *lexical_names = f->static_info->body.lexical_names;
     if (lexical_names) {
         MVMLexicalRegistry *entry;
-        MVM_string_flatten(tc, name);
-        MVM_HASH_GET(tc, lexical_names, name, entry)
+        MVM_HASH_GET(tc, lexical_names, name, entry);
         if (entry && f->static_info->body.lexical_types[entry->value] == type) {
             MVMRegister *result = &f->env[entry->value];
             if (type == MVM_reg_obj && !result->o)
@@ -1379,8 +1373,7 @@ MVMuint16 MVM_frame_lexical_primspec(MVMThreadContext *tc, MVMFrame *f, MVMStrin
     MVMLexicalRegistry *lexical_names = f->static_info->body.lexical_names;
     if (lexical_names) {
         MVMLexicalRegistry *entry;
-        MVM_string_flatten(tc, name);
-        MVM_HASH_GET(tc, lexical_names, name, entry)
+        MVM_HASH_GET(tc, lexical_names, name, entry);
         if (entry) {
             switch (f->static_info->body.lexical_types[entry->value]) {
                 case MVM_reg_int64:
@@ -1,18 +1,16 @@
 #include "moar.h"
 
 MVMHLLConfig *MVM_hll_get_config_for(MVMThreadContext *tc, MVMString *name) {
-    void *kdata;
     MVMHLLConfig *entry;
-    size_t klen;
 
-    MVM_HASH_EXTRACT_KEY(tc, &kdata, &klen, name, "get hll config needs concrete string");
+    MVM_HASH_CHECK_KEY(tc, (MVMObject *)name, "get hll config needs concrete string");
 
     uv_mutex_lock(&tc->instance->mutex_hllconfigs);
 
     if (tc->instance->hll_compilee_depth)
-        HASH_FIND(hash_handle, tc->instance->compilee_hll_configs, kdata, klen, entry);
+        MVM_HASH_GET(tc, tc->instance->compilee_hll_configs, name, entry);
     else
-        HASH_FIND(hash_handle, tc->instance->compiler_hll_configs, kdata, klen, entry);
+        MVM_HASH_GET(tc, tc->instance->compiler_hll_configs, name, entry);
 
     if (!entry) {
         entry = calloc(sizeof(MVMHLLConfig), 1);
@@ -35,9 +33,9 @@ MVMHLLConfig *MVM_hll_get_config_for(MVMThreadContext *tc, MVMString *name) {
         entry->bind_error = NULL;
         entry->method_not_found_error = NULL;
         if (tc->instance->hll_compilee_depth)
-            HASH_ADD_KEYPTR(hash_handle, tc->instance->compilee_hll_configs, kdata, klen, entry);
+            MVM_HASH_BIND(tc, tc->instance->compilee_hll_configs, name, entry, name);
         else
-            HASH_ADD_KEYPTR(hash_handle, tc->instance->compiler_hll_configs, kdata, klen, entry);
+            MVM_HASH_BIND(tc, tc->instance->compiler_hll_configs, name, entry, name);
         MVM_gc_root_add_permanent(tc, (MVMCollectable **)&entry->int_box_type);
         MVM_gc_root_add_permanent(tc, (MVMCollectable **)&entry->num_box_type);
         MVM_gc_root_add_permanent(tc, (MVMCollectable **)&entry->str_box_type);
@@ -155,6 +155,11 @@ struct MVMInstance {
     /* Log file for specializations, if we're to log them. */
     FILE *spesh_log_fh;
 
+    /* Log file for per-thread GC run statistics, if we're to log them, and
+     * a mutex so that threads finishing a run at once write whole lines. */
+    FILE      *gc_stats_fh;
+    uv_mutex_t mutex_gc_stats_log;
+
     /* Log file for dynamic var performance, if we're to log it. */
     FILE *dynvar_log_fh;
 
@@ -193,9 +198,38 @@ struct MVMInstance {
     MVMCollectable     ***permroots;
     uv_mutex_t            mutex_permroots;
 
+    /* Bounds on the size of each thread's nursery semi-spaces. */
+    MVMuint32 nursery_size_min;
+    MVMuint32 nursery_size_max;
+
     /* The current GC run sequence number. May wrap around over time; that
      * is fine since only equality ever matters. */
     AO_t gc_seq_number;
+    /* Whether the current GC run is a full collection. */
+    AO_t gc_full_collect;
+    /* Bytes promoted to gen2 since the last full collection, bytes found
+     * live in gen2 by that collection, and the percentage growth over that
+     * which triggers the next one. */
+    AO_t gc_promoted_bytes;
+    AO_t gc_live_bytes;
+    MVMuint32 gc_gen2_growth;
+    /* Total bytes of empty gen2 and FSA pages handed back to the OS. */
+    AO_t gc_released_bytes;
+    /* GC statistics: how many runs there have been (and how many of them
+     * were full collections), when the latest started and ended, and totals
+     * of thread pause time in nanoseconds, bytes copied within and promoted
+     * out of nurseries, and chunks of gen2 marking work stolen. */
+    AO_t gc_stats_runs;
+    AO_t gc_stats_full_runs;
+    MVMuint64 gc_stats_last_start;
+    MVMuint64 gc_stats_last_end;
+    AO_t gc_stats_pause;
+    AO_t gc_stats_copied;
+    AO_t gc_stats_promoted;
+    AO_t gc_stats_stolen;
+
+    /* Snapshot of the heap, taken at the end of the latest GC run. */
+    MVMGCHeapStats *gc_stats_heap;
     /* The number of threads that vote for starting GC. */
     AO_t gc_start;
     /* The number of threads that still need to vote for considering GC done. */
@@ -204,8 +238,16 @@ struct MVMInstance {
     AO_t gc_intrays_clearing;
     /* The number of threads that have yet to acknowledge the finish. */
     AO_t gc_ack;
+    /* During a full collection, the number of threads still marking their
+     * own (or stolen) work, and the number looking for work to steal. */
+    AO_t gc_marking;
+    AO_t gc_stealers;
     /* Linked list (via forwarder) of STables to free. */
     MVMSTable *stables_to_free;
+    /* STables taken from that list at the end of the last full collection;
+     * they are only freed at the end of the next one, as dead objects that
+     * point to them may not be swept until then. */
+    MVMSTable *stables_awaiting_sweep;
 
     /* MVMThreads completed starting, running, and/or exited. */
     /* note: used atomically */
@@ -275,6 +317,15 @@ struct MVMInstance {
     MVMuint32                     all_scs_next_idx;
     MVMuint32                     all_scs_alloc;
 
+    /* Table of interned strings, held weakly, plus the entries whose
+     * string may still be in a nursery, so that nursery-only GC runs need
+     * not walk the whole table. */
+    MVMInternedString  *interned_strings;
+    MVMInternedString **interned_nursery;
+    MVMuint32           num_interned_nursery;
+    MVMuint32           alloc_interned_nursery;
+    uv_mutex_t          mutex_interned_strings;
+
     /* Hash of filenames of compunits loaded from disk. */
     MVMLoadedCompUnitName *loaded_compunits;
     uv_mutex_t       mutex_loaded_compunits;
@@ -11,6 +11,11 @@
 #define GET_UI32(pc, idx)   *((MVMuint32 *)(pc + idx))
 #define GET_N32(pc, idx)    *((MVMnum32 *)(pc + idx))
 
+/* The attribute hint for an attribute access instruction; when the compiler
+ * didn't know it, it comes from the instruction's inline cache. */
+#define ATTR_HINT(hint, obj, ch, name) ((hint) != MVM_NO_HINT ? (MVMint64)(hint) : \
+    MVM_6model_attr_hint_inline(tc, (obj), (ch), (name), (MVMuint32)(cur_op - bytecode_start)))
+
 #define NEXT_OP (op = *(MVMuint16 *)(cur_op), cur_op += 2, op)
 
 #if MVM_CGOTO
@@ -897,7 +902,6 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                     MVMuint8 found = 0;
                     if (!sf->body.fully_deserialized)
                         MVM_bytecode_finish_frame(tc, sf->body.cu, sf, 0);
-                    MVM_string_flatten(tc, name);
                     if (sf->body.lexical_names) {
                         MVMLexicalRegistry *entry;
                         MVM_HASH_GET(tc, sf->body.lexical_names, name, entry);
@@ -1942,8 +1946,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMRegister *res  = &GET_REG(cur_op, 0);
                 MVMObject   *obj  = GET_REG(cur_op, 2).o;
                 MVMString   *name = cu->body.strings[GET_UI32(cur_op, 4)];
+                MVMuint32    site = cur_op - bytecode_start;
                 cur_op += 8;
-                MVM_6model_find_method(tc, obj, name, res);
+                MVM_6model_find_method_inline(tc, obj, name, res, site);
                 goto NEXT;
             }
             OP(findmeth_s):  {
@@ -1951,8 +1956,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMRegister *res  = &GET_REG(cur_op, 0);
                 MVMObject   *obj  = GET_REG(cur_op, 2).o;
                 MVMString   *name = GET_REG(cur_op, 4).s;
+                MVMuint32    site = cur_op - bytecode_start;
                 cur_op += 6;
-                MVM_6model_find_method(tc, obj, name, res);
+                MVM_6model_find_method_inline(tc, obj, name, res, site);
                 goto NEXT;
             }
             OP(can): {
@@ -1960,8 +1966,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMRegister *res  = &GET_REG(cur_op, 0);
                 MVMObject   *obj  = GET_REG(cur_op, 2).o;
                 MVMString   *name = cu->body.strings[GET_UI32(cur_op, 4)];
+                MVMuint32    site = cur_op - bytecode_start;
                 cur_op += 8;
-                MVM_6model_can_method(tc, obj, name, res);
+                MVM_6model_can_method_inline(tc, obj, name, res, site);
                 goto NEXT;
             }
             OP(can_s): {
@@ -1969,8 +1976,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVMRegister *res  = &GET_REG(cur_op, 0);
                 MVMObject   *obj  = GET_REG(cur_op, 2).o;
                 MVMString   *name = GET_REG(cur_op, 4).s;
+                MVMuint32    site = cur_op - bytecode_start;
                 cur_op += 6;
-                MVM_6model_can_method(tc, obj, name, res);
+                MVM_6model_can_method_inline(tc, obj, name, res, site);
                 goto NEXT;
             }
             OP(create): {
@@ -2354,7 +2362,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, cu->body.strings[GET_UI32(cur_op, 4)],
-                    GET_I16(cur_op, 10), GET_REG(cur_op, 8), MVM_reg_int64);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 2).o,
+                        cu->body.strings[GET_UI32(cur_op, 4)]),
+                    GET_REG(cur_op, 8), MVM_reg_int64);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 12;
                 goto NEXT;
@@ -2366,7 +2376,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, cu->body.strings[GET_UI32(cur_op, 4)],
-                    GET_I16(cur_op, 10), GET_REG(cur_op, 8), MVM_reg_num64);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 2).o,
+                        cu->body.strings[GET_UI32(cur_op, 4)]),
+                    GET_REG(cur_op, 8), MVM_reg_num64);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 12;
                 goto NEXT;
@@ -2378,7 +2390,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, cu->body.strings[GET_UI32(cur_op, 4)],
-                    GET_I16(cur_op, 10), GET_REG(cur_op, 8), MVM_reg_str);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 2).o,
+                        cu->body.strings[GET_UI32(cur_op, 4)]),
+                    GET_REG(cur_op, 8), MVM_reg_str);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 12;
                 goto NEXT;
@@ -2390,7 +2404,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, cu->body.strings[GET_UI32(cur_op, 4)],
-                    GET_I16(cur_op, 10), GET_REG(cur_op, 8), MVM_reg_obj);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 2).o,
+                        cu->body.strings[GET_UI32(cur_op, 4)]),
+                    GET_REG(cur_op, 8), MVM_reg_obj);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 12;
                 goto NEXT;
@@ -2402,7 +2418,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s,
-                    -1, GET_REG(cur_op, 6), MVM_reg_int64);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s),
+                    GET_REG(cur_op, 6), MVM_reg_int64);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 8;
                 goto NEXT;
@@ -2414,7 +2431,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s,
-                    -1, GET_REG(cur_op, 6), MVM_reg_num64);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s),
+                    GET_REG(cur_op, 6), MVM_reg_num64);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 8;
                 goto NEXT;
@@ -2426,7 +2444,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s,
-                    -1, GET_REG(cur_op, 6), MVM_reg_str);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s),
+                    GET_REG(cur_op, 6), MVM_reg_str);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 8;
                 goto NEXT;
@@ -2438,7 +2457,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.bind_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s,
-                    -1, GET_REG(cur_op, 6), MVM_reg_obj);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).s),
+                    GET_REG(cur_op, 6), MVM_reg_obj);
                 MVM_SC_WB_OBJ(tc, obj);
                 cur_op += 8;
                 goto NEXT;
@@ -2450,7 +2470,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, cu->body.strings[GET_UI32(cur_op, 6)],
-                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0), MVM_reg_int64);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 4).o,
+                        cu->body.strings[GET_UI32(cur_op, 6)]),
+                    &GET_REG(cur_op, 0), MVM_reg_int64);
                 cur_op += 12;
                 goto NEXT;
             }
@@ -2461,7 +2483,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, cu->body.strings[GET_UI32(cur_op, 6)],
-                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0), MVM_reg_num64);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 4).o,
+                        cu->body.strings[GET_UI32(cur_op, 6)]),
+                    &GET_REG(cur_op, 0), MVM_reg_num64);
                 cur_op += 12;
                 goto NEXT;
             }
@@ -2472,7 +2496,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, cu->body.strings[GET_UI32(cur_op, 6)],
-                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0), MVM_reg_str);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 4).o,
+                        cu->body.strings[GET_UI32(cur_op, 6)]),
+                    &GET_REG(cur_op, 0), MVM_reg_str);
                 cur_op += 12;
                 goto NEXT;
             }
@@ -2483,7 +2509,9 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, cu->body.strings[GET_UI32(cur_op, 6)],
-                    GET_I16(cur_op, 10), &GET_REG(cur_op, 0), MVM_reg_obj);
+                    ATTR_HINT(GET_I16(cur_op, 10), obj, GET_REG(cur_op, 4).o,
+                        cu->body.strings[GET_UI32(cur_op, 6)]),
+                    &GET_REG(cur_op, 0), MVM_reg_obj);
                 cur_op += 12;
                 goto NEXT;
             }
@@ -2494,7 +2522,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s,
-                    -1, &GET_REG(cur_op, 0), MVM_reg_int64);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s),
+                    &GET_REG(cur_op, 0), MVM_reg_int64);
                 cur_op += 8;
                 goto NEXT;
             }
@@ -2505,7 +2534,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s,
-                    -1, &GET_REG(cur_op, 0), MVM_reg_num64);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s),
+                    &GET_REG(cur_op, 0), MVM_reg_num64);
                 cur_op += 8;
                 goto NEXT;
             }
@@ -2516,7 +2546,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s,
-                    -1, &GET_REG(cur_op, 0), MVM_reg_str);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s),
+                    &GET_REG(cur_op, 0), MVM_reg_str);
                 cur_op += 8;
                 goto NEXT;
             }
@@ -2527,7 +2558,8 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 REPR(obj)->attr_funcs.get_attribute(tc,
                     STABLE(obj), obj, OBJECT_BODY(obj),
                     GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s,
-                    -1, &GET_REG(cur_op, 0), MVM_reg_obj);
+                    ATTR_HINT(MVM_NO_HINT, obj, GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).s),
+                    &GET_REG(cur_op, 0), MVM_reg_obj);
                 cur_op += 8;
                 goto NEXT;
             }
@@ -2684,8 +2716,7 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 goto NEXT;
             }
             OP(composetype): {
-                MVMObject *obj = GET_REG(cur_op, 2).o;
-                REPR(obj)->compose(tc, STABLE(obj), GET_REG(cur_op, 4).o);
+                MVM_repr_compose(tc, GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).o);
                 GET_REG(cur_op, 0).o = GET_REG(cur_op, 2).o;
                 cur_op += 6;
                 goto NEXT;
@@ -4295,6 +4326,40 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 MVM_proc_kill_async(tc, GET_REG(cur_op, 0).o, GET_REG(cur_op, 2).i64);
                 cur_op += 4;
                 goto NEXT;
+            OP(gcstats):
+                GET_REG(cur_op, 0).o = MVM_gc_stats(tc);
+                cur_op += 2;
+                goto NEXT;
+            OP(arrcopy):
+                MVM_array_copy(tc, GET_REG(cur_op, 0).o, GET_REG(cur_op, 2).i64,
+                    GET_REG(cur_op, 4).o, GET_REG(cur_op, 6).i64,
+                    GET_REG(cur_op, 8).i64);
+                cur_op += 10;
+                goto NEXT;
+            OP(arrappend):
+                MVM_array_append(tc, GET_REG(cur_op, 0).o, GET_REG(cur_op, 2).o);
+                cur_op += 4;
+                goto NEXT;
+            OP(arrfill_i):
+                MVM_array_fill_i(tc, GET_REG(cur_op, 0).o, GET_REG(cur_op, 2).i64,
+                    GET_REG(cur_op, 4).i64, GET_REG(cur_op, 6).i64);
+                cur_op += 8;
+                goto NEXT;
+            OP(arrfill_n):
+                MVM_array_fill_n(tc, GET_REG(cur_op, 0).o, GET_REG(cur_op, 2).n64,
+                    GET_REG(cur_op, 4).i64, GET_REG(cur_op, 6).i64);
+                cur_op += 8;
+                goto NEXT;
+            OP(arrcmp):
+                GET_REG(cur_op, 0).i64 = MVM_array_compare(tc,
+                    GET_REG(cur_op, 2).o, GET_REG(cur_op, 4).o);
+                cur_op += 6;
+                goto NEXT;
+            OP(arrindex_i):
+                GET_REG(cur_op, 0).i64 = MVM_array_index_i(tc, GET_REG(cur_op, 2).o,
+                    GET_REG(cur_op, 4).i64, GET_REG(cur_op, 6).i64);
+                cur_op += 8;
+                goto NEXT;
             OP(sp_log):
                 if (tc->cur_frame->spesh_log_idx >= 0) {
                     MVM_ASSIGN_REF(tc, &(tc->cur_frame->static_info->common.header),
@@ -4475,10 +4540,12 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 goto NEXT;
             }
             OP(sp_fastcreate): {
-                /* Assume we're in normal code, so doing a nursery allocation.
-                 * Also, that there is no initialize. */
+                /* Assume we're in normal code, so doing a nursery allocation,
+                 * unless the type is pretenured. Also, that there is no
+                 * initialize. */
                 MVMuint16 size       = GET_UI16(cur_op, 2);
-                MVMObject *obj       = MVM_gc_allocate_zeroed(tc, size);
+                MVMSTable *st        = (MVMSTable *)tc->cur_frame->effective_spesh_slots[GET_UI16(cur_op, 4)];
+                MVMObject *obj       = MVM_gc_allocate_for_type(tc, st, size);
                 obj->st              = (MVMSTable *)tc->cur_frame->effective_spesh_slots[GET_UI16(cur_op, 4)];
                 obj->header.size     = size;
                 obj->header.owner    = tc->thread_id;
@@ -4602,6 +4669,62 @@ void MVM_interp_run(MVMThreadContext *tc, void (*initial_invoke)(MVMThreadContex
                 }
                 goto NEXT;
             }
+            OP(sp_p6oget_i32): {
+                MVMObject *o     = GET_REG(cur_op, 2).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                GET_REG(cur_op, 0).i64 = *((MVMint32 *)(data + GET_UI16(cur_op, 4)));
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6oget_i16): {
+                MVMObject *o     = GET_REG(cur_op, 2).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                GET_REG(cur_op, 0).i64 = *((MVMint16 *)(data + GET_UI16(cur_op, 4)));
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6oget_i8): {
+                MVMObject *o     = GET_REG(cur_op, 2).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                GET_REG(cur_op, 0).i64 = *((MVMint8 *)(data + GET_UI16(cur_op, 4)));
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6oget_n32): {
+                MVMObject *o     = GET_REG(cur_op, 2).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                GET_REG(cur_op, 0).n64 = *((MVMnum32 *)(data + GET_UI16(cur_op, 4)));
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6obind_i32): {
+                MVMObject *o     = GET_REG(cur_op, 0).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                *((MVMint32 *)(data + GET_UI16(cur_op, 2))) = (MVMint32)GET_REG(cur_op, 4).i64;
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6obind_i16): {
+                MVMObject *o     = GET_REG(cur_op, 0).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                *((MVMint16 *)(data + GET_UI16(cur_op, 2))) = (MVMint16)GET_REG(cur_op, 4).i64;
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6obind_i8): {
+                MVMObject *o     = GET_REG(cur_op, 0).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                *((MVMint8 *)(data + GET_UI16(cur_op, 2))) = (MVMint8)GET_REG(cur_op, 4).i64;
+                cur_op += 6;
+                goto NEXT;
+            }
+            OP(sp_p6obind_n32): {
+                MVMObject *o     = GET_REG(cur_op, 0).o;
+                char      *data  = MVM_p6opaque_real_data(tc, OBJECT_BODY(o));
+                *((MVMnum32 *)(data + GET_UI16(cur_op, 2))) = (MVMnum32)GET_REG(cur_op, 4).n64;
+                cur_op += 6;
+                goto NEXT;
+            }
 #if MVM_CGOTO
             OP_CALL_EXTOP: {
                 /* Bounds checking? Never heard of that. */
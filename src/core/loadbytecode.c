@@ -19,7 +19,6 @@ void MVM_load_bytecode(MVMThreadContext *tc, MVMString *filename) {
 
     /* See if we already loaded this. */
     uv_mutex_lock(&tc->instance->mutex_loaded_compunits);
-    MVM_string_flatten(tc, filename);
     MVM_HASH_GET(tc, tc->instance->loaded_compunits, filename, loaded_name);
     if (loaded_name) {
         /* already loaded */
@@ -54,7 +53,7 @@ void MVM_load_bytecode(MVMThreadContext *tc, MVMString *filename) {
         }
         loaded_name = calloc(1, sizeof(MVMLoadedCompUnitName));
         loaded_name->filename = filename;
-        MVM_HASH_BIND(tc, tc->instance->loaded_compunits, filename, loaded_name);
+        MVM_HASH_BIND(tc, tc->instance->loaded_compunits, filename, loaded_name, filename);
     });
 
     uv_mutex_unlock(&tc->instance->mutex_loaded_compunits);
@@ -60,6 +60,9 @@ struct MVMNativeCallback {
 struct MVMNativeCallbackCacheHead {
     MVMNativeCallback *head;
 
+    /* The compilation unit ID of the callback, which is the hash key. */
+    MVMString *cuid;
+
     /* The uthash hash handle inline struct. */
     UT_hash_handle hash_handle;
 };
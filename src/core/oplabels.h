@@ -613,6 +613,13 @@ static const void * const LABELS[] = {
     &&OP_nativecallcast,
     &&OP_spawnprocasync,
     &&OP_killprocasync,
+    &&OP_gcstats,
+    &&OP_arrcopy,
+    &&OP_arrappend,
+    &&OP_arrfill_i,
+    &&OP_arrfill_n,
+    &&OP_arrcmp,
+    &&OP_arrindex_i,
     &&OP_sp_log,
     &&OP_sp_osrfinalize,
     &&OP_sp_guardconc,
@@ -651,21 +658,14 @@ static const void * const LABELS[] = {
     &&OP_sp_p6obind_n,
     &&OP_sp_p6obind_s,
     &&OP_sp_jit_enter,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
+    &&OP_sp_p6oget_i32,
+    &&OP_sp_p6oget_i16,
+    &&OP_sp_p6oget_i8,
+    &&OP_sp_p6oget_n32,
+    &&OP_sp_p6obind_i32,
+    &&OP_sp_p6obind_i16,
+    &&OP_sp_p6obind_i8,
+    &&OP_sp_p6obind_n32,
     NULL,
     NULL,
     NULL,
@@ -613,44 +613,59 @@
 #define MVM_OP_nativecallcast 609
 #define MVM_OP_spawnprocasync 610
 #define MVM_OP_killprocasync 611
-#define MVM_OP_sp_log 612
-#define MVM_OP_sp_osrfinalize 613
-#define MVM_OP_sp_guardconc 614
-#define MVM_OP_sp_guardtype 615
-#define MVM_OP_sp_guardcontconc 616
-#define MVM_OP_sp_guardconttype 617
-#define MVM_OP_sp_getarg_o 618
-#define MVM_OP_sp_getarg_i 619
-#define MVM_OP_sp_getarg_n 620
-#define MVM_OP_sp_getarg_s 621
-#define MVM_OP_sp_fastinvoke_v 622
-#define MVM_OP_sp_fastinvoke_i 623
-#define MVM_OP_sp_fastinvoke_n 624
-#define MVM_OP_sp_fastinvoke_s 625
-#define MVM_OP_sp_fastinvoke_o 626
-#define MVM_OP_sp_namedarg_used 627
-#define MVM_OP_sp_getspeshslot 628
-#define MVM_OP_sp_findmeth 629
-#define MVM_OP_sp_fastcreate 630
-#define MVM_OP_sp_get_o 631
-#define MVM_OP_sp_get_i 632
-#define MVM_OP_sp_get_n 633
-#define MVM_OP_sp_get_s 634
-#define MVM_OP_sp_bind_o 635
-#define MVM_OP_sp_bind_i 636
-#define MVM_OP_sp_bind_n 637
-#define MVM_OP_sp_bind_s 638
-#define MVM_OP_sp_p6oget_o 639
-#define MVM_OP_sp_p6ogetvt_o 640
-#define MVM_OP_sp_p6ogetvc_o 641
-#define MVM_OP_sp_p6oget_i 642
-#define MVM_OP_sp_p6oget_n 643
-#define MVM_OP_sp_p6oget_s 644
-#define MVM_OP_sp_p6obind_o 645
-#define MVM_OP_sp_p6obind_i 646
-#define MVM_OP_sp_p6obind_n 647
-#define MVM_OP_sp_p6obind_s 648
-#define MVM_OP_sp_jit_enter 649
+#define MVM_OP_gcstats 612
+#define MVM_OP_arrcopy 613
+#define MVM_OP_arrappend 614
+#define MVM_OP_arrfill_i 615
+#define MVM_OP_arrfill_n 616
+#define MVM_OP_arrcmp 617
+#define MVM_OP_arrindex_i 618
+#define MVM_OP_sp_log 619
+#define MVM_OP_sp_osrfinalize 620
+#define MVM_OP_sp_guardconc 621
+#define MVM_OP_sp_guardtype 622
+#define MVM_OP_sp_guardcontconc 623
+#define MVM_OP_sp_guardconttype 624
+#define MVM_OP_sp_getarg_o 625
+#define MVM_OP_sp_getarg_i 626
+#define MVM_OP_sp_getarg_n 627
+#define MVM_OP_sp_getarg_s 628
+#define MVM_OP_sp_fastinvoke_v 629
+#define MVM_OP_sp_fastinvoke_i 630
+#define MVM_OP_sp_fastinvoke_n 631
+#define MVM_OP_sp_fastinvoke_s 632
+#define MVM_OP_sp_fastinvoke_o 633
+#define MVM_OP_sp_namedarg_used 634
+#define MVM_OP_sp_getspeshslot 635
+#define MVM_OP_sp_findmeth 636
+#define MVM_OP_sp_fastcreate 637
+#define MVM_OP_sp_get_o 638
+#define MVM_OP_sp_get_i 639
+#define MVM_OP_sp_get_n 640
+#define MVM_OP_sp_get_s 641
+#define MVM_OP_sp_bind_o 642
+#define MVM_OP_sp_bind_i 643
+#define MVM_OP_sp_bind_n 644
+#define MVM_OP_sp_bind_s 645
+#define MVM_OP_sp_p6oget_o 646
+#define MVM_OP_sp_p6ogetvt_o 647
+#define MVM_OP_sp_p6ogetvc_o 648
+#define MVM_OP_sp_p6oget_i 649
+#define MVM_OP_sp_p6oget_n 650
+#define MVM_OP_sp_p6oget_s 651
+#define MVM_OP_sp_p6obind_o 652
+#define MVM_OP_sp_p6obind_i 653
+#define MVM_OP_sp_p6obind_n 654
+#define MVM_OP_sp_p6obind_s 655
+#define MVM_OP_sp_jit_enter 656
+#define MVM_OP_sp_p6oget_i32 657
+#define MVM_OP_sp_p6oget_i16 658
+#define MVM_OP_sp_p6oget_i8 659
+#define MVM_OP_sp_p6oget_n32 660
+#define MVM_OP_sp_p6obind_i32 661
+#define MVM_OP_sp_p6obind_i16 662
+#define MVM_OP_sp_p6obind_i8 663
+#define MVM_OP_sp_p6obind_n32 664
 
 #define MVM_OP_EXT_BASE 1024
 #define MVM_OP_EXT_CU_LIMIT 1024
@@ -1,19 +1,30 @@
 #include "moar.h"
+#include "platform/time.h"
 
 /* Initializes a new thread context. Note that this doesn't set up a
  * thread itself, it just creates the data structure that exists in
  * MoarVM per thread. */
 MVMThreadContext * MVM_tc_create(MVMInstance *instance) {
     MVMThreadContext *tc = calloc(1, sizeof(MVMThreadContext));
+    MVMuint32 nursery_size;
 
     /* Associate with VM instance. */
     tc->instance = instance;
 
-    /* Set up GC nursery. */
-    tc->nursery_fromspace   = calloc(1, MVM_NURSERY_SIZE);
-    tc->nursery_tospace     = calloc(1, MVM_NURSERY_SIZE);
-    tc->nursery_alloc       = tc->nursery_tospace;
-    tc->nursery_alloc_limit = (char *)tc->nursery_alloc + MVM_NURSERY_SIZE;
+    /* Set up GC nursery, starting out at the default size (so long as that
+     * is within the configured bounds). */
+    nursery_size = MVM_NURSERY_SIZE;
+    if (nursery_size < instance->nursery_size_min)
+        nursery_size = instance->nursery_size_min;
+    if (nursery_size > instance->nursery_size_max)
+        nursery_size = instance->nursery_size_max;
+    tc->nursery_fromspace      = calloc(1, nursery_size);
+    tc->nursery_tospace        = calloc(1, nursery_size);
+    tc->nursery_fromspace_size = nursery_size;
+    tc->nursery_tospace_size   = nursery_size;
+    tc->nursery_alloc          = tc->nursery_tospace;
+    tc->nursery_alloc_limit    = (char *)tc->nursery_alloc + nursery_size;
+    tc->nursery_last_gc        = MVM_platform_now();
 
     /* Set up temporary root handling. */
     tc->num_temproots   = 0;
@@ -28,6 +39,9 @@ MVMThreadContext * MVM_tc_create(MVMInstance *instance) {
     /* Set up the second generation allocator. */
     tc->gen2 = MVM_gc_gen2_create(instance);
 
+    /* Set up the thread's cache of fixed size allocator slots. */
+    MVM_fixed_size_create_thread(tc);
+
     /* Set up table of per-static-frame chains. */
     /* XXX For non-first threads, make them start with the size of the
        main thread's table. or, look into lazily initializing this. */
@@ -69,6 +83,9 @@ void MVM_tc_destroy(MVMThreadContext *tc) {
     /* Destroy the second generation allocator. */
     MVM_gc_gen2_destroy(tc->instance, tc->gen2);
 
+    /* Hand any cached fixed size allocator slots back. */
+    MVM_fixed_size_destroy_thread(tc);
+
     /* Free the thread-specific storage */
     MVM_checked_free_null(tc->gc_work);
     MVM_checked_free_null(tc->temproots);
@@ -113,9 +113,26 @@ struct MVMThreadContext {
      * allocate new ones. */
     void *nursery_tospace;
 
+    /* The sizes of the two semi-spaces. These may differ for a while after
+     * the nursery is resized, since only the space we just evacuated can be
+     * reallocated at the end of a collection. */
+    MVMuint32 nursery_fromspace_size;
+    MVMuint32 nursery_tospace_size;
+
+    /* Statistics used to decide how to resize the nursery: the number of
+     * bytes that survived the current collection (copied to tospace or
+     * promoted), the time the last collection ended, and the number of
+     * collections in a row the nursery was mostly unused. */
+    MVMuint32 nursery_survived;
+    MVMuint64 nursery_last_gc;
+    MVMuint32 nursery_underused_runs;
+
     /* The second GC generation allocator. */
     MVMGen2Allocator *gen2;
 
+    /* This thread's cache of free fixed size allocator slots. */
+    MVMFixedSizeAllocThread *thread_fsa;
+
     /* Memory buffer pointing to the last thing we serialized, intended to go
      * into the next compilation unit we write. */
     char         *serialized;
@@ -141,6 +158,25 @@ struct MVMThreadContext {
     /* The GC's cross-thread in-tray of processing work. */
     MVMGCPassedWork *gc_in_tray;
 
+    /* Bytes of gen2 objects found live by this thread during the current
+     * full collection. */
+    MVMuint64        gc_live_bytes;
+
+    /* GC statistics: bytes copied within and promoted out of this thread's
+     * nursery and chunks of marking work it stole during the current run,
+     * and how long it was paused by the last run and by all of them. */
+    MVMuint64        gc_stats_copied;
+    MVMuint64        gc_stats_promoted;
+    MVMuint32        gc_stats_stolen;
+    MVMuint32        gc_stats_runs;
+    MVMuint64        gc_stats_last_pause;
+    MVMuint64        gc_stats_pause;
+
+    /* Chunks of gen2 marking work offered up for other threads to steal
+     * during a full collection, and a lock protecting the list. */
+    MVMGCPassedWork *gc_steal_chunks;
+    AO_t             gc_steal_lock;
+
     /* Threads we will do GC work for this run (ourself plus any that we stole
      * work from because they were blocked). */
     MVMWorkThread   *gc_work;
@@ -190,6 +190,60 @@ static void validate_final_return(Validator *val) {
 }
 
 
+/* Is the op at the given position one that has an inline cache when run
+ * unspecialized? Attribute accesses only do if the compiler gave no hint. */
+static MVMint32 has_cache_site(MVMuint8 *op) {
+    switch (*(MVMuint16 *)op) {
+        case MVM_OP_findmeth:
+        case MVM_OP_findmeth_s:
+        case MVM_OP_can:
+        case MVM_OP_can_s:
+        case MVM_OP_getattrs_i:
+        case MVM_OP_getattrs_n:
+        case MVM_OP_getattrs_s:
+        case MVM_OP_getattrs_o:
+        case MVM_OP_bindattrs_i:
+        case MVM_OP_bindattrs_n:
+        case MVM_OP_bindattrs_s:
+        case MVM_OP_bindattrs_o:
+            return 1;
+        case MVM_OP_getattr_i:
+        case MVM_OP_getattr_n:
+        case MVM_OP_getattr_s:
+        case MVM_OP_getattr_o:
+        case MVM_OP_bindattr_i:
+        case MVM_OP_bindattr_n:
+        case MVM_OP_bindattr_s:
+        case MVM_OP_bindattr_o:
+            return GET_I16(op, 12) == MVM_NO_HINT;
+        default:
+            return 0;
+    }
+}
+
+/* Numbers the inline cache sites in the frame, in bytecode order, by
+ * recording the offset of each one's operands. */
+static void locate_cache_sites(Validator *val) {
+    MVMStaticFrameBody *fb = &val->frame->body;
+    MVMuint32 pos, num_sites = 0;
+
+    for (pos = 0; pos < val->bc_size; pos++)
+        if ((val->labels[pos] & MVM_BC_op_boundary)
+                && has_cache_site(val->bc_start + pos))
+            num_sites++;
+
+    fb->num_cache_sites    = num_sites;
+    fb->cache_site_offsets = NULL;
+    if (num_sites) {
+        fb->cache_site_offsets = malloc(num_sites * sizeof(MVMuint32));
+        for (pos = 0, num_sites = 0; pos < val->bc_size; pos++)
+            if ((val->labels[pos] & MVM_BC_op_boundary)
+                    && has_cache_site(val->bc_start + pos))
+                fb->cache_site_offsets[num_sites++] = pos + 2;
+    }
+}
+
+
 static void validate_literal_operand(Validator *val, MVMuint32 flags) {
     MVMuint32 type = flags & MVM_operand_type_mask;
     MVMuint32 size;
@@ -635,7 +689,9 @@ void MVM_validate_static_frame(MVMThreadContext *tc,
     validate_branch_targets(val);
     validate_final_return(val);
 
-    /* Validation successful. Cache the located instruction offsets. */
+    /* Validation successful. Cache the located instruction offsets and
+     * inline cache sites. */
+    locate_cache_sites(val);
     fb->instr_offsets = val->labels;
 }
 
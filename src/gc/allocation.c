@@ -5,6 +5,25 @@
 
 #include "moar.h"
 
+/* Allocates an object straight into the second generation, because its
+ * type is pretenured. The object goes on the gen2 roots list, which covers
+ * plain stores of nursery references into it, such as of its STable, made
+ * before anything else can trigger a GC. That only lasts until the next GC,
+ * which drops it from the list if it no longer points into the nursery; so
+ * anything that may GC and then store into the object, such as allocating
+ * a child under MVMROOT, must use MVM_ASSIGN_REF. REPR initialize functions
+ * of types that can be pretenured must do so for that reason. Such allocations don't use up the nursery, so
+ * once they come to as much as it holds we collect anyway; that way gen2
+ * growth from them is noticed, and the roots list doesn't grow unbounded. */
+static void * allocate_direct_gen2(MVMThreadContext *tc, size_t size) {
+    MVMCollectable *col;
+    if (tc->gen2->promoted_bytes >= tc->nursery_tospace_size)
+        MVM_gc_enter_from_allocator(tc);
+    col = MVM_gc_gen2_allocate_zeroed(tc, tc->gen2, (MVMuint32)size);
+    MVM_gc_root_gen2_add(tc, col);
+    return col;
+}
+
 /* Allocate the specified amount of memory from the nursery. Will
  * trigger a GC run if there is not enough. */
 void * MVM_gc_allocate_nursery(MVMThreadContext *tc, size_t size) {
@@ -26,11 +45,8 @@ void * MVM_gc_allocate_nursery(MVMThreadContext *tc, size_t size) {
          * actually gets freed up. The next run will promote them to the
          * second generation. Note that this circumstance is exceptionally
          * unlikely in any non-contrived situation. */
-        while ((char *)tc->nursery_alloc + size >= (char *)tc->nursery_alloc_limit) {
-            if (size > MVM_NURSERY_SIZE)
-                MVM_panic(MVM_exitcode_gcalloc, "Attempt to allocate more than the maximum nursery size");
+        while ((char *)tc->nursery_alloc + size >= (char *)tc->nursery_alloc_limit)
             MVM_gc_enter_from_allocator(tc);
-        }
 
         /* Allocate (just bump the pointer). */
         allocated = tc->nursery_alloc;
@@ -79,16 +95,49 @@ MVMObject * MVM_gc_allocate_type_object(MVMThreadContext *tc, MVMSTable *st) {
     return obj;
 }
 
+/* Allocates memory for an object of the given type. Types whose objects
+ * nearly all get promoted are allocated straight into gen2, saving copying
+ * them around the nursery first. Every so often a pretenured type goes back
+ * to the nursery for another sample, in case its objects have stopped
+ * living so long. For other types, we keep track of how many we allocate,
+ * and now and then compare that with how many got promoted. The counts are
+ * updated without synchronization, so threads allocating objects of the
+ * same type at once may lose some updates; they only need to be roughly
+ * right for a decision that is revisited anyway. */
+void * MVM_gc_allocate_for_type(MVMThreadContext *tc, MVMSTable *st, size_t size) {
+    if (st->pretenure && !tc->allocate_in_gen2) {
+        /* Update the counts before anything that may GC, since that may
+         * move the STable, and we only have it by value. */
+        if (++st->pretenure_allocs >= MVM_GC_PRETENURE_RECHECK) {
+            st->pretenure            = 0;
+            st->pretenure_allocs     = 0;
+            st->pretenure_promotions = 0;
+        }
+        if (tc->gc_status)
+            MVM_gc_enter_from_interrupt(tc);
+        return allocate_direct_gen2(tc, size);
+    }
+    if (++st->pretenure_allocs >= MVM_GC_PRETENURE_SAMPLE) {
+        if ((MVMuint64)st->pretenure_promotions * 100
+                >= (MVMuint64)st->pretenure_allocs * MVM_GC_PRETENURE_SURVIVAL)
+            st->pretenure = 1;
+        st->pretenure_allocs     = 0;
+        st->pretenure_promotions = 0;
+    }
+    return MVM_gc_allocate_zeroed(tc, size);
+}
+
 /* Allocates a new object, and points it at the specified STable. */
 MVMObject * MVM_gc_allocate_object(MVMThreadContext *tc, MVMSTable *st) {
     MVMObject *obj;
     MVMROOT(tc, st, {
-        obj               = MVM_gc_allocate_zeroed(tc, st->size);
+        obj               = MVM_gc_allocate_for_type(tc, st, st->size);
         obj->header.size  = (MVMuint16)st->size;
         obj->header.owner = tc->thread_id;
         MVM_ASSIGN_REF(tc, &(obj->header), obj->st, st);
         if ((obj->header.flags & MVM_CF_SECOND_GEN))
-            if (REPR(obj)->refs_frames)
+            if (REPR(obj)->refs_frames
+                    && !(obj->header.flags & MVM_CF_IN_GEN2_ROOT_LIST))
                 MVM_gc_root_gen2_add(tc, (MVMCollectable *)obj);
     });
     return obj;
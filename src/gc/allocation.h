@@ -1,11 +1,20 @@
+/* A type's objects are allocated straight into gen2 once, over a sample of
+ * this many nursery allocations, promotions come to at least the given
+ * percentage of them. After the given number of allocations straight into
+ * gen2, the type is sampled in the nursery again. */
+#define MVM_GC_PRETENURE_SAMPLE   4096
+#define MVM_GC_PRETENURE_SURVIVAL 90
+#define MVM_GC_PRETENURE_RECHECK  65536
+
 void * MVM_gc_allocate_nursery(MVMThreadContext *tc, size_t size);
 void * MVM_gc_allocate_zeroed(MVMThreadContext *tc, size_t size);
 MVMSTable * MVM_gc_allocate_stable(MVMThreadContext *tc, const MVMREPROps *repr, MVMObject *how);
 MVMObject * MVM_gc_allocate_type_object(MVMThreadContext *tc, MVMSTable *st);
 MVMObject * MVM_gc_allocate_object(MVMThreadContext *tc, MVMSTable *st);
+void * MVM_gc_allocate_for_type(MVMThreadContext *tc, MVMSTable *st, size_t size);
 void MVM_gc_allocate_gen2_default_set(MVMThreadContext *tc);
 void MVM_gc_allocate_gen2_default_clear(MVMThreadContext *tc);
 
 #define MVM_gc_allocate(tc, size) (tc->allocate_in_gen2 \
-    ? MVM_gc_gen2_allocate_zeroed(tc->gen2, size) \
+    ? MVM_gc_gen2_allocate_zeroed(tc, tc->gen2, size) \
     : MVM_gc_allocate_nursery(tc, size))
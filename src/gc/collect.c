@@ -1,4 +1,5 @@
 #include "moar.h"
+#include "platform/time.h"
 
 /* Combines a piece of work that will be passed to another thread with the
  * ID of the target thread to pass it to. */
@@ -18,6 +19,8 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
 static void pass_work_item(MVMThreadContext *tc, WorkToPass *wtp, MVMCollectable **item_ptr);
 static void pass_leftover_work(MVMThreadContext *tc, WorkToPass *wtp);
 static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist);
+static void add_passed_work_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMGCPassedWork *head);
+static void process_shared_work(MVMThreadContext *tc, MVMGCWorklist *worklist, WorkToPass *wtp, MVMuint8 gen);
 
 /* Does a garbage collection run. Exactly what it does is configured by the
  * couple of arguments that it takes.
@@ -54,12 +57,19 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
         /* Swap fromspace and tospace. */
         void * fromspace = tc->nursery_tospace;
         void * tospace   = tc->nursery_fromspace;
-        tc->nursery_fromspace = fromspace;
-        tc->nursery_tospace   = tospace;
+        MVMuint32 fromspace_size = tc->nursery_tospace_size;
+        MVMuint32 tospace_size   = tc->nursery_fromspace_size;
+        tc->nursery_fromspace      = fromspace;
+        tc->nursery_tospace        = tospace;
+        tc->nursery_fromspace_size = fromspace_size;
+        tc->nursery_tospace_size   = tospace_size;
 
         /* Reset nursery allocation pointers to the new tospace. */
         tc->nursery_alloc       = tospace;
-        tc->nursery_alloc_limit = (char *)tc->nursery_alloc + MVM_NURSERY_SIZE;
+        tc->nursery_alloc_limit = (char *)tc->nursery_alloc + tospace_size;
+
+        /* Start counting survivors afresh. */
+        tc->nursery_survived = 0;
 
         MVM_gc_worklist_add(tc, worklist, &tc->thread_obj);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : processing %d items from thread_obj\n", worklist->items);
@@ -126,6 +136,9 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
         process_worklist(tc, worklist, &wtp, gen);
     }
 
+    /* Take back any marking work we offered up but nobody stole. */
+    process_shared_work(tc, worklist, &wtp, gen);
+
     /* Destroy the worklist. */
     MVM_gc_worklist_destroy(tc, worklist);
 
@@ -137,6 +150,70 @@ void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen) {
     }
 }
 
+/* Looks through the other threads for gen2 marking work they have offered up
+ * during a full collection, and if some is found steals and processes it.
+ * Returns non-zero if work was found. */
+MVMuint32 MVM_gc_collect_steal(MVMThreadContext *tc) {
+    MVMGCPassedWork *work = NULL;
+    MVMThread       *cur_thread;
+    MVMGCWorklist   *worklist;
+    WorkToPass       wtp;
+
+    cur_thread = (MVMThread *)MVM_load(&tc->instance->threads);
+    while (cur_thread && !work) {
+        MVMThreadContext *victim = cur_thread->body.tc;
+        if (victim && victim != tc)
+            work = MVM_gc_worklist_take_shared(tc, victim);
+        cur_thread = cur_thread->body.next;
+    }
+    if (!work)
+        return 0;
+
+    /* Taking the work counted us as marking; other idle threads keep looking
+     * for work that we may in turn offer up until we're done. */
+    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : stole %d items of gen2 marking work\n",
+        work->num_items);
+    tc->gc_stats_stolen++;
+    wtp.num_target_threads = 0;
+    wtp.target_work = NULL;
+    worklist = MVM_gc_worklist_create(tc, 1);
+    add_passed_work_to_worklist(tc, worklist, work);
+    process_worklist(tc, worklist, &wtp, MVMGCGenerations_Both);
+    process_shared_work(tc, worklist, &wtp, MVMGCGenerations_Both);
+    MVM_gc_worklist_destroy(tc, worklist);
+    if (wtp.num_target_threads) {
+        pass_leftover_work(tc, &wtp);
+        free(wtp.target_work);
+    }
+    MVM_decr(&tc->instance->gc_marking);
+
+    return 1;
+}
+
+/* Processes any work we offered up for stealing that is still there. */
+static void process_shared_work(MVMThreadContext *tc, MVMGCWorklist *worklist, WorkToPass *wtp, MVMuint8 gen) {
+    MVMGCPassedWork *work;
+    if (gen != MVMGCGenerations_Both)
+        return;
+    while ((work = MVM_gc_worklist_take_shared(tc, tc))) {
+        add_passed_work_to_worklist(tc, worklist, work);
+        process_worklist(tc, worklist, wtp, gen);
+    }
+}
+
+/* Marks a gen2 object as live. Since any thread may mark gen2 objects in a
+ * full collection, we may race with another; returns non-zero if we won and
+ * so should go on to mark the object's referents. */
+static MVMuint32 mark_gen2_live(MVMCollectable *item) {
+    while (1) {
+        MVMuint16 flags = item->flags;
+        if (flags & MVM_CF_GEN2_LIVE)
+            return 0;
+        if (MVM_trycas16(&item->flags, flags, flags | MVM_CF_GEN2_LIVE))
+            return 1;
+    }
+}
+
 /* Processes the current worklist. */
 static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, WorkToPass *wtp, MVMuint8 gen) {
     MVMGen2Allocator  *gen2;
@@ -151,12 +228,22 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
 
     MVM_gc_worklist_mark_frame_roots(tc, worklist);
 
-    while ((item_ptr = MVM_gc_worklist_get(tc, worklist))) {
-        /* Dereference the object we're considering. */
-        MVMCollectable *item = *item_ptr;
+    while (1) {
+        MVMCollectable *item;
         MVMuint8 item_gen2;
         MVMuint8 to_gen2 = 0;
 
+        /* In a full collection, if we have plenty of work and another thread
+         * is idle, offer it some of our gen2 marking. */
+        if (gen == MVMGCGenerations_Both && worklist->items >= worklist->share_at
+                && MVM_load(&tc->instance->gc_stealers))
+            MVM_gc_worklist_share(tc, worklist);
+
+        /* Dereference the object we're considering. */
+        if (!(item_ptr = MVM_gc_worklist_get(tc, worklist)))
+            break;
+        item = *item_ptr;
+
         /* If the item is NULL, that's fine - it's just a null reference and
          * thus we've no object to consider. */
         if (item == NULL)
@@ -196,8 +283,9 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
         }
 
         /* If it's owned by a different thread, we need to pass it over to
-         * the owning thread. */
-        if (item->owner != tc->thread_id) {
+         * the owning thread. The exception is gen2 objects, which we need
+         * only mark, and any thread may do that. */
+        if (item->owner != tc->thread_id && !item_gen2) {
             GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : sending a handle %p to object %p to thread %d\n", item_ptr, item, item->owner);
             pass_work_item(tc, wtp, item_ptr);
             continue;
@@ -212,12 +300,15 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
          * need to take some action. Go on the generation... */
         if (item_gen2) {
             assert(!(item->flags & MVM_CF_FORWARDER_VALID));
-            /* It's in the second generation. We'll just mark it. */
+            /* It's in the second generation. We'll just mark it, unless
+             * another thread beat us to it. */
             new_addr = item;
             if (MVM_GC_DEBUG_ENABLED(MVM_GC_DEBUG_COLLECT)) {
                 GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : handle %p was already %p\n", item_ptr, new_addr);
             }
-            item->flags |= MVM_CF_GEN2_LIVE;
+            if (!mark_gen2_live(item))
+                continue;
+            tc->gc_live_bytes += item->size;
             assert(*item_ptr == new_addr);
         } else {
             /* Catch NULL stable (always sign of trouble) in debug mode. */
@@ -226,33 +317,50 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
                 printf("%d", ((MVMCollectable *)1)->owner);
             }
 
-            /* Did we see it in the nursery before? */
-            if (item->flags & MVM_CF_NURSERY_SEEN) {
+            /* Keep track of how much survives, for nursery sizing. */
+            tc->nursery_survived += item->size;
+
+            /* Did we see it in the nursery before? Also, if the nursery was
+             * shrunk, tospace may be too small for everything that survived,
+             * in which case we promote what doesn't fit. */
+            if ((item->flags & MVM_CF_NURSERY_SEEN) ||
+                    (char *)tc->nursery_alloc + item->size > (char *)tc->nursery_alloc_limit) {
                 /* Yes; we should move it to the second generation. Allocate
                  * space in the second generation. */
                 to_gen2 = 1;
-                new_addr = MVM_gc_gen2_allocate(gen2, item->size);
+                new_addr = MVM_gc_gen2_allocate(tc, gen2, item->size);
 
                 /* Copy the object to the second generation and mark it as
                  * living there. */
                 GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : copying an object %p of size %d to gen2 %p\n",
                     item, item->size, new_addr);
                 memcpy(new_addr, item, item->size);
-                new_addr->flags ^= MVM_CF_NURSERY_SEEN;
+                new_addr->flags &= ~MVM_CF_NURSERY_SEEN;
                 new_addr->flags |= MVM_CF_SECOND_GEN;
+                tc->gc_stats_promoted += item->size;
 
-                /* If it references frames or static frames, we need to keep
-                 * on visiting it. */
+                /* Count the promotion for pretenuring decisions. If it
+                 * references frames or static frames, we need to keep on
+                 * visiting it. */
                 if (!(new_addr->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
                     MVMObject *new_obj_addr = (MVMObject *)new_addr;
+                    MVMSTable *st           = new_obj_addr->st;
+
+                    /* The STable may already have moved in this same run; if
+                     * so, count it at its new location, or it'd be lost. */
+                    if (st->header.flags & MVM_CF_FORWARDER_VALID)
+                        st = (MVMSTable *)st->header.sc_forward_u.forwarder;
+                    st->pretenure_promotions++;
                     if (REPR(new_obj_addr)->refs_frames)
                         MVM_gc_root_gen2_add(tc, (MVMCollectable *)new_obj_addr);
                 }
 
                 /* If we're going to sweep the second generation, also need
                  * to mark it as live. */
-                if (gen == MVMGCGenerations_Both)
+                if (gen == MVMGCGenerations_Both) {
                     new_addr->flags |= MVM_CF_GEN2_LIVE;
+                    tc->gc_live_bytes += item->size;
+                }
             }
             else {
                 /* No, so it will live in the nursery for another GC
@@ -267,6 +375,7 @@ static void process_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, Work
                  * older generation, if it survives). */
                 memcpy(new_addr, item, item->size);
                 new_addr->flags |= MVM_CF_NURSERY_SEEN;
+                tc->gc_stats_copied += item->size;
             }
 
             /* Store the forwarding pointer and update the original
@@ -479,6 +588,11 @@ static void add_in_tray_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklis
     }
 
     /* Go through list, adding to worklist. */
+    add_passed_work_to_worklist(tc, worklist, head);
+}
+
+/* Adds the items in a chain of passed work to the worklist, freeing it. */
+static void add_passed_work_to_worklist(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMGCPassedWork *head) {
     while (head) {
         MVMGCPassedWork *next = head->next;
         MVMuint32 i;
@@ -563,166 +677,358 @@ void MVM_gc_collect_free_nursery_uncopied(MVMThreadContext *tc, void *limit) {
     }
 }
 
-/* Free STables (in any thread/generation!) queued to be freed. */
-void MVM_gc_collect_free_stables(MVMThreadContext *tc) {
-    MVMSTable *st = tc->instance->stables_to_free;
+/* Decides whether the nursery should grow or shrink, based on how much of
+ * it was used (up to limit) in the run that just happened, how much of that
+ * survived, and how long it was since the previous run. Only the fromspace
+ * is free to be replaced at this point (everything in it is either copied
+ * or dead), so that is the semi-space resized; the new size becomes the one
+ * we allocate in once the spaces are swapped at the next collection, and
+ * the other space will follow it the run after. */
+void MVM_gc_collect_resize_nursery(MVMThreadContext *tc, void *limit) {
+    MVMInstance *i       = tc->instance;
+    MVMuint64    now     = MVM_platform_now();
+    MVMuint32    used    = (MVMuint32)((char *)limit - (char *)tc->nursery_fromspace);
+    MVMuint32    current = tc->nursery_fromspace_size;
+    MVMuint32    target  = current;
+
+    if (used >= current / 2) {
+        /* Well used; grow if we're collecting very often or if a lot of what
+         * we allocate lives beyond a single collection. */
+        tc->nursery_underused_runs = 0;
+        if (now - tc->nursery_last_gc < MVM_NURSERY_GROW_INTERVAL
+                || (MVMuint64)tc->nursery_survived * 100 > (MVMuint64)used * MVM_NURSERY_GROW_SURVIVAL)
+            target = current * 2;
+    }
+    else if (used < current / 4) {
+        /* Hardly used; shrink if that's been the case for a while. */
+        if (++tc->nursery_underused_runs >= MVM_NURSERY_SHRINK_RUNS) {
+            tc->nursery_underused_runs = 0;
+            target = current / 2;
+        }
+    }
+    else {
+        tc->nursery_underused_runs = 0;
+    }
+
+    /* Apply bounds. */
+    if (target < i->nursery_size_min)
+        target = i->nursery_size_min;
+    if (target > i->nursery_size_max)
+        target = i->nursery_size_max;
+
+    if (target != current) {
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : resizing nursery from %u to %u bytes\n",
+            current, target);
+        free(tc->nursery_fromspace);
+        tc->nursery_fromspace      = calloc(1, target);
+        tc->nursery_fromspace_size = target;
+    }
+
+    tc->nursery_last_gc = now;
+}
+
+/* Takes the list of STables queued to be freed. Other threads may still be
+ * finishing their part of a GC run and queueing more, which will be left for
+ * next time. */
+static MVMSTable * take_stables_to_free(MVMThreadContext *tc) {
+    MVMSTable *head;
+    do {
+        head = tc->instance->stables_to_free;
+    } while (!MVM_trycas(&tc->instance->stables_to_free, head, NULL));
+    return head;
+}
+
+/* Frees a list of STables linked through the forwarder. */
+static void free_stable_list(MVMThreadContext *tc, MVMSTable *st) {
     while (st) {
         MVMSTable *st_to_free = st;
         st = st_to_free->header.sc_forward_u.st;
         st_to_free->header.sc_forward_u.st = NULL;
         MVM_6model_stable_gc_free(tc, st_to_free);
     }
-    tc->instance->stables_to_free = NULL;
 }
 
-/* Goes through the unmarked objects in the second generation heap and builds
- * free lists out of them. Also does any required finalization. */
-void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc) {
-    /* Visit each of the size class bins. */
-    MVMGen2Allocator *gen2 = tc->gen2;
-    MVMuint32 bin, obj_size, page, i;
-    char ***freelist_insert_pos;
-    for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
-        /* If we've nothing allocated in this size class, skip it. */
-        if (gen2->size_classes[bin].pages == NULL)
-            continue;
+/* Free STables (in any thread/generation!) queued to be freed. Used in
+ * global destruction, once everything has been swept. */
+void MVM_gc_collect_free_stables(MVMThreadContext *tc) {
+    free_stable_list(tc, tc->instance->stables_awaiting_sweep);
+    tc->instance->stables_awaiting_sweep = NULL;
+    free_stable_list(tc, take_stables_to_free(tc));
+}
 
-        /* Calculate object size for this bin. */
-        obj_size = (bin + 1) << MVM_GEN2_BIN_BITS;
-
-        /* freelist_insert_pos is a pointer to a memory location that
-         * stores the address of the last traversed free list node (char **). */
-        /* Initialize freelist insertion position to free list head. */
-        freelist_insert_pos = &gen2->size_classes[bin].free_list;
-
-        /* Visit each page. */
-        for (page = 0; page < gen2->size_classes[bin].num_pages; page++) {
-            /* Visit all the objects, looking for dead ones and reset the
-             * mark for each of them. */
-            char *cur_ptr = gen2->size_classes[bin].pages[page];
-            char *end_ptr = page + 1 == gen2->size_classes[bin].num_pages
-                ? gen2->size_classes[bin].alloc_pos
-                : cur_ptr + obj_size * MVM_GEN2_PAGE_ITEMS;
-            char **last_insert_pos = NULL;
-            while (cur_ptr < end_ptr) {
-                MVMCollectable *col = (MVMCollectable *)cur_ptr;
-
-                /* Is this already a free list slot? If so, it becomes the
-                 * new free list insert position. */
-                if (*freelist_insert_pos == (char **)cur_ptr) {
-                    freelist_insert_pos = (char ***)cur_ptr;
-                }
+/* Called at the end of a full collection to free the STables that no dead
+ * object still awaiting a sweep can point to. An object that points to an
+ * STable died before it did, so will have been found dead by the first full
+ * collection after the STable was queued, and swept by the time the one
+ * after that starts marking. So those taken now are freed next time. */
+void MVM_gc_collect_free_swept_stables(MVMThreadContext *tc) {
+    free_stable_list(tc, tc->instance->stables_awaiting_sweep);
+    tc->instance->stables_awaiting_sweep = take_stables_to_free(tc);
+}
 
-                /* Otherwise, it must be a collectable of some kind. Is it
-                 * live? */
-                else if (col->flags & MVM_CF_GEN2_LIVE) {
-                    /* Yes; clear the mark. */
-                    col->flags &= ~MVM_CF_GEN2_LIVE;
-                }
-                else {
-                    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : collecting an object %p in the gen2\n", col);
-                    /* No, it's dead. Do any cleanup. */
-                    if (!(col->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
-                        /* Object instance; call gc_free if needed. */
-                        MVMObject *obj = (MVMObject *)col;
-                        if (REPR(obj)->gc_free)
-                            REPR(obj)->gc_free(tc, obj);
+/* Does any required finalization of a dead gen2 collectable. Returns non-zero
+ * if its slot must stay in use for now, which is the case for an STable that
+ * has only just died. */
+static MVMuint32 finalize_gen2_dead(MVMThreadContext *tc, MVMCollectable *col, MVMuint8 global_destruction) {
+    GCDEBUG_LOG(tc, MVM_GC_DEBUG_COLLECT, "Thread %d run %d : collecting an object %p in the gen2\n", col);
+    if (!(col->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
+        /* Object instance; call gc_free if needed. */
+        MVMObject *obj = (MVMObject *)col;
+        if (REPR(obj)->gc_free)
+            REPR(obj)->gc_free(tc, obj);
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
-                            free(col->sc_forward_u.sci);
+        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
+            free(col->sc_forward_u.sci);
 #endif
-                    }
-                    else if (col->flags & MVM_CF_TYPE_OBJECT) {
+    }
+    else if (col->flags & MVM_CF_TYPE_OBJECT) {
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
-                            free(col->sc_forward_u.sci);
+        if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
+            free(col->sc_forward_u.sci);
 #endif
-                    }
-                    else if (col->flags & MVM_CF_STABLE) {
-                        if (
+    }
+    else if (col->flags & MVM_CF_STABLE) {
+        if (
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                            !(col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) &&
+            !(col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) &&
 #endif
-                            col->sc_forward_u.sc.sc_idx == 0
-                            && col->sc_forward_u.sc.idx == MVM_DIRECT_SC_IDX_SENTINEL) {
-                            /* We marked it dead last time, kill it. */
-                            MVM_6model_stable_gc_free(tc, (MVMSTable *)col);
-                        }
-                        else {
+            col->sc_forward_u.sc.sc_idx == 0
+            && col->sc_forward_u.sc.idx == MVM_DIRECT_SC_IDX_SENTINEL) {
+            /* We marked it dead last time, kill it. */
+            MVM_6model_stable_gc_free(tc, (MVMSTable *)col);
+        }
+        else {
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                            if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) {
-                                /* Whatever happens next, we can free this
-                                   memory immediately, because no-one will be
-                                   serializing a dead STable. */
-                                assert(!(col->sc_forward_u.sci->sc_idx == 0
-                                         && col->sc_forward_u.sci->idx
-                                         == MVM_DIRECT_SC_IDX_SENTINEL));
-                                free(col->sc_forward_u.sci);
-                                col->flags &= ~MVM_CF_SERIALZATION_INDEX_ALLOCATED;
-                            }
+            if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED) {
+                /* Whatever happens next, we can free this
+                   memory immediately, because no-one will be
+                   serializing a dead STable. */
+                assert(!(col->sc_forward_u.sci->sc_idx == 0
+                         && col->sc_forward_u.sci->idx
+                         == MVM_DIRECT_SC_IDX_SENTINEL));
+                free(col->sc_forward_u.sci);
+                col->flags &= ~MVM_CF_SERIALZATION_INDEX_ALLOCATED;
+            }
 #endif
-                            if (MVM_load(&tc->gc_status) == MVMGCStatus_NONE) {
-                                /* We're in global destruction, so enqueue to the end
-                                 * like we do in the nursery */
-                                MVM_gc_collect_enqueue_stable_for_deletion(tc, (MVMSTable *)col);
-                            } else {
-                                /* There will definitely be another gc run, so mark it as "died last time". */
-                                col->sc_forward_u.sc.sc_idx = 0;
-                                col->sc_forward_u.sc.idx = MVM_DIRECT_SC_IDX_SENTINEL;
-                            }
-                            /* Skip the freelist updating. */
-                            cur_ptr += obj_size;
-                            continue;
-                        }
-                    }
-                    else {
-                        printf("item flags: %d\n", col->flags);
-                        MVM_panic(MVM_exitcode_gcnursery, "Internal error: impossible case encountered in gen2 GC free");
-                    }
-
-                    /* Chain in to the free list. */
-                    *((char **)cur_ptr) = (char *)*freelist_insert_pos;
-                    *freelist_insert_pos = (char **)cur_ptr;
-
-                    /* Update the pointer to the insert position to point to us */
-                    freelist_insert_pos = (char ***)cur_ptr;
-                }
-
-                /* Move to the next object. */
-                cur_ptr += obj_size;
+            if (global_destruction) {
+                /* We're in global destruction, so enqueue to the end
+                 * like we do in the nursery */
+                MVM_gc_collect_enqueue_stable_for_deletion(tc, (MVMSTable *)col);
+            } else {
+                /* There will definitely be another gc run, so mark it as "died last time". */
+                col->sc_forward_u.sc.sc_idx = 0;
+                col->sc_forward_u.sc.idx = MVM_DIRECT_SC_IDX_SENTINEL;
             }
+            return 1;
         }
     }
-    
-    /* Also need to consider overflows. */
-    for (i = 0; i < gen2->num_overflows; i++) {
-        if (gen2->overflows[i]) {
-            MVMCollectable *col = gen2->overflows[i];
-            if (col->flags & MVM_CF_GEN2_LIVE) {
-                /* A living over-sized object; just clear the mark. */
-                col->flags &= ~MVM_CF_GEN2_LIVE;
-            }
-            else {
-                /* Dead over-sized object. We know if it's this big it cannot
-                 * be a type object or STable, so only need handle the simple
-                 * object case. */
-                if (!(col->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
-                    MVMObject *obj = (MVMObject *)col;
-                    if (REPR(obj)->gc_free)
-                        REPR(obj)->gc_free(tc, obj);
+    else {
+        printf("item flags: %d\n", col->flags);
+        MVM_panic(MVM_exitcode_gcnursery, "Internal error: impossible case encountered in gen2 GC free");
+    }
+    return 0;
+}
+
+/* Sweeps the next page awaiting a sweep in a gen2 size class, adding dead
+ * objects to the free list and clearing the mark on living ones. The dead
+ * were already finalized when the sweep started, while the world was still
+ * stopped, so there is nothing more to do with them here. The free list is
+ * rebuilt in page order as we go, taking in the slots that were already on
+ * it as we come across them. Returns zero if there was nothing to sweep. */
+static MVMuint32 sweep_gen2_page(MVMThreadContext *tc, MVMuint32 bin) {
+    MVMGen2SizeClass *sc       = &tc->gen2->size_classes[bin];
+    MVMuint32         obj_size = (bin + 1) << MVM_GEN2_BIN_BITS;
+    MVMuint32         page     = sc->sweep_page;
+    MVMuint32         live     = 0;
+    char  **page_free_list     = NULL;
+    char ***page_free_tail     = &page_free_list;
+    char *cur_ptr, *end_ptr;
+
+    if (page >= sc->sweep_num_pages)
+        return 0;
+
+    /* Visit all the objects, looking for dead ones and reset the mark for
+     * each of them. */
+    cur_ptr = sc->pages[page];
+    end_ptr = page + 1 == sc->num_pages
+        ? sc->alloc_pos
+        : cur_ptr + obj_size * MVM_GEN2_PAGE_ITEMS;
+    while (cur_ptr < end_ptr) {
+        MVMCollectable *col = (MVMCollectable *)cur_ptr;
+
+        /* Is this already a free list slot? If so, it moves over to the new
+         * free list. */
+        if ((char *)sc->sweep_free_list == cur_ptr) {
+            sc->sweep_free_list = (char **)*sc->sweep_free_list;
+        }
+
+        /* Otherwise, it must be a collectable of some kind. Is it
+         * live? */
+        else if (col->flags & MVM_CF_GEN2_LIVE) {
+            /* Yes; clear the mark. */
+            col->flags &= ~MVM_CF_GEN2_LIVE;
+            live++;
+            cur_ptr += obj_size;
+            continue;
+        }
+
+        /* Otherwise it's dead, and its slot is free from now on. */
+        else {
+            sc->used_items--;
+        }
+
+        /* Chain in to the end of this page's free slots. */
+        *((char **)cur_ptr) = NULL;
+        *page_free_tail = (char **)cur_ptr;
+        page_free_tail  = (char ***)cur_ptr;
+
+        /* Move to the next object. */
+        cur_ptr += obj_size;
+    }
+
+    /* If nothing on the page is live, and we're not still bump-allocating
+     * in it, give it back to the OS; the page that followed it takes its
+     * place as the next to sweep. Otherwise, its free slots go on the end
+     * of the free list. */
+    if (live == 0 && page + 1 < sc->num_pages) {
+        MVM_gc_gen2_release_page(tc, tc->gen2, bin, page);
+    }
+    else {
+        if (page_free_list) {
+            *sc->free_list_tail = page_free_list;
+            sc->free_list_tail  = page_free_tail;
+        }
+        sc->sweep_page++;
+    }
+
+    /* If that was the last page, anything left of the old free list (which
+     * there should not be) goes on the end of the new one. */
+    if (sc->sweep_page == sc->sweep_num_pages && sc->sweep_free_list) {
+        *sc->free_list_tail = sc->sweep_free_list;
+        sc->sweep_free_list = NULL;
+    }
+
+    return 1;
+}
+
+/* Sweeps the next page of a gen2 size class that still awaits sweeping after
+ * the last full collection. Called by the gen2 allocator when it runs out of
+ * free slots. Returns zero if there was nothing left to sweep. */
+MVMuint32 MVM_gc_collect_sweep_gen2_page(MVMThreadContext *tc, MVMuint32 bin) {
+    return sweep_gen2_page(tc, bin);
+}
+
+/* Finalizes the dead objects in the pages of a size class that is about to
+ * be lazily swept. Finalizers may release OS handles, mutexes and the like,
+ * so this can't wait until the allocator gets around to the page with other
+ * threads running. An STable that has to stay around for now is marked as
+ * live, so that the sweep keeps its slot. */
+static void finalize_gen2_size_class(MVMThreadContext *tc, MVMuint32 bin, MVMuint8 global_destruction) {
+    MVMGen2SizeClass *sc        = &tc->gen2->size_classes[bin];
+    MVMuint32         obj_size  = (bin + 1) << MVM_GEN2_BIN_BITS;
+    char            **free_slot = sc->sweep_free_list;
+    MVMuint32         page;
+    for (page = 0; page < sc->sweep_num_pages; page++) {
+        char *cur_ptr = sc->pages[page];
+        char *end_ptr = page + 1 == sc->num_pages
+            ? sc->alloc_pos
+            : cur_ptr + obj_size * MVM_GEN2_PAGE_ITEMS;
+        for (; cur_ptr < end_ptr; cur_ptr += obj_size) {
+            MVMCollectable *col = (MVMCollectable *)cur_ptr;
+            if ((char *)free_slot == cur_ptr)
+                free_slot = (char **)*free_slot;
+            else if (!(col->flags & MVM_CF_GEN2_LIVE))
+                if (finalize_gen2_dead(tc, col, global_destruction))
+                    col->flags |= MVM_CF_GEN2_LIVE;
+        }
+    }
+}
+
+/* Starts sweeping the second generation heap after a full collection's mark
+ * phase, with the world still stopped. */
+static void start_gen2_sweep(MVMThreadContext *tc, MVMuint8 global_destruction) {
+    MVMGen2Allocator   *gen2 = tc->gen2;
+    MVMGen2LargeObject *lo;
+    MVMuint32 bin;
+
+    /* Any sweeping left from last time must be done first, so we don't mix
+     * up old and new marks. */
+    MVM_gc_collect_finish_gen2_sweep(tc);
+
+    for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
+        MVMGen2SizeClass *sc = &gen2->size_classes[bin];
+
+        /* If we've nothing allocated in this size class, skip it. */
+        if (sc->pages == NULL)
+            continue;
+
+        /* Take the free list aside; the sweep will rebuild it, picking up
+         * the slots on it in page order. */
+        sc->sweep_free_list = sc->free_list;
+        sc->free_list       = NULL;
+        sc->free_list_tail  = &sc->free_list;
+        sc->sweep_page      = 0;
+        sc->sweep_num_pages = sc->num_pages;
+        finalize_gen2_size_class(tc, bin, global_destruction);
+    }
+
+    /* Also need to consider the large object space. */
+    lo = gen2->large_objects;
+    while (lo) {
+        MVMCollectable *col = MVM_GEN2_LARGE_OBJECT(lo);
+        lo = lo->next;
+        if (col->flags & MVM_CF_GEN2_LIVE) {
+            /* A living large object; just clear the mark. */
+            col->flags &= ~MVM_CF_GEN2_LIVE;
+        }
+        else {
+            /* Dead large object. We know if it's this big it cannot be a
+             * type object or STable, so only need handle the simple object
+             * case. */
+            if (!(col->flags & (MVM_CF_TYPE_OBJECT | MVM_CF_STABLE))) {
+                MVMObject *obj = (MVMObject *)col;
+                if (REPR(obj)->gc_free)
+                    REPR(obj)->gc_free(tc, obj);
 #ifdef MVM_USE_OVERFLOW_SERIALIZATION_INDEX
-                    if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
-                        free(col->sc_forward_u.sci);
+                if (col->flags & MVM_CF_SERIALZATION_INDEX_ALLOCATED)
+                    free(col->sc_forward_u.sci);
 #endif
-                }
-                else {
-                    MVM_panic(MVM_exitcode_gcnursery, "Internal error: gen2 overflow contains non-object");
-                }
-                free(col);
-                gen2->overflows[i] = NULL;
             }
+            else {
+                MVM_panic(MVM_exitcode_gcnursery, "Internal error: large object space contains non-object");
+            }
+            MVM_gc_gen2_free_large(gen2, col);
         }
     }
-    /* And finally compact the overflow list */
-    MVM_gc_gen2_compact_overflows(gen2);
+}
+
+/* Called at the end of a full collection's mark phase, with the world still
+ * stopped. Dead objects are finalized right away, but rather than building
+ * free lists out of them and giving back empty pages while the world waits,
+ * we mark all of the pages as needing a sweep; this is then done on demand
+ * as the gen2 allocator needs free slots, or at the latest before the next
+ * full collection starts marking. Large objects live outside of the pages,
+ * so they are freed here and now. */
+void MVM_gc_collect_start_gen2_sweep(MVMThreadContext *tc) {
+    start_gen2_sweep(tc, 0);
+}
+
+/* Sweeps all pages of the second generation heap that are still waiting to
+ * be swept since the last full collection. */
+void MVM_gc_collect_finish_gen2_sweep(MVMThreadContext *tc) {
+    MVMuint32 bin;
+    for (bin = 0; bin < MVM_GEN2_BINS; bin++)
+        while (sweep_gen2_page(tc, bin))
+            ;
+}
+
+/* Goes through the unmarked objects in the second generation heap and builds
+ * free lists out of them, right away. Also does any required finalization.
+ * This is used in global destruction, where everything unmarked is dead. */
+void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc) {
+    MVMuint32 bin;
+    start_gen2_sweep(tc, 1);
+    for (bin = 0; bin < MVM_GEN2_BINS; bin++)
+        while (sweep_gen2_page(tc, bin))
+            ;
 }
@@ -1,12 +1,37 @@
 /* How big is the nursery area? Note that since it's semi-space copying, we
- * actually have double this amount allocated. Also it is per thread. (In
- * the future, we'll make this adaptive rather than a constant.) */
+ * actually have double this amount allocated. Also it is per thread. This is
+ * the size a nursery starts out at; after each collection it is grown or
+ * shrunk to fit the thread's allocation behavior, staying within the min
+ * and max sizes below (which can be overridden with the MVM_NURSERY_MIN_SIZE
+ * and MVM_NURSERY_MAX_SIZE environment variables). */
 #define MVM_NURSERY_SIZE 4194304
+#define MVM_NURSERY_MIN_SIZE 262144
+#define MVM_NURSERY_MAX_SIZE 67108864
 
-/* How often do we collect the second generation? This is specified as the
- * number of nursery runs that happen per full collection. For example, if
- * this is set to 10 then every tenth collection will involve the full heap. */
-#define MVM_GC_GEN2_RATIO 25
+/* Whatever the environment says, nurseries stay within these bounds. The
+ * lower one must leave room for the biggest possible collectable. */
+#define MVM_NURSERY_SIZE_FLOOR 65536
+#define MVM_NURSERY_SIZE_CEILING 1073741824
+
+/* A nursery that was at least half used is grown if it filled up again in
+ * less than this many nanoseconds since the last collection, or if more
+ * than this percentage of what was allocated in it survived. */
+#define MVM_NURSERY_GROW_INTERVAL 20000000
+#define MVM_NURSERY_GROW_SURVIVAL 25
+
+/* A nursery that was less than a quarter used for this many collections in
+ * a row is shrunk. */
+#define MVM_NURSERY_SHRINK_RUNS 4
+
+/* How often do we collect the second generation? We keep count of the bytes
+ * promoted to (or allocated directly in) gen2 since the last full collection,
+ * and do another once that reaches this percentage of what the last full
+ * collection found to be live in gen2. The percentage can be overridden with
+ * the MVM_GC_GEN2_GROWTH environment variable, up to the maximum below.
+ * Until gen2 has grown by the minimum below, we never bother. */
+#define MVM_GC_GEN2_GROWTH      25
+#define MVM_GC_GEN2_MAX_GROWTH  10000
+#define MVM_GC_GEN2_MIN_GROWTH  8388608
 
 /* What things should be processed in this GC run? */
 typedef enum {
@@ -45,6 +70,12 @@ struct MVMGCPassedWork {
 /* Functions. */
 void MVM_gc_collect(MVMThreadContext *tc, MVMuint8 what_to_do, MVMuint8 gen);
 void MVM_gc_collect_free_nursery_uncopied(MVMThreadContext *tc, void *limit);
+void MVM_gc_collect_resize_nursery(MVMThreadContext *tc, void *limit);
 void MVM_gc_collect_free_gen2_unmarked(MVMThreadContext *tc);
+void MVM_gc_collect_start_gen2_sweep(MVMThreadContext *tc);
+MVMuint32 MVM_gc_collect_sweep_gen2_page(MVMThreadContext *tc, MVMuint32 bin);
+void MVM_gc_collect_finish_gen2_sweep(MVMThreadContext *tc);
+MVMuint32 MVM_gc_collect_steal(MVMThreadContext *tc);
 void MVM_gc_mark_collectable(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMCollectable *item);
 void MVM_gc_collect_free_stables(MVMThreadContext *tc);
+void MVM_gc_collect_free_swept_stables(MVMThreadContext *tc);
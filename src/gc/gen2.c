@@ -1,4 +1,5 @@
 #include "moar.h"
+#include "platform/mmap.h"
 
 /* Creates a new second generation allocator. */
 MVMGen2Allocator * MVM_gc_gen2_create(MVMInstance *i) {
@@ -9,14 +10,24 @@ MVMGen2Allocator * MVM_gc_gen2_create(MVMInstance *i) {
     al->size_classes = malloc(sizeof(MVMGen2SizeClass) * MVM_GEN2_BINS);
     memset(al->size_classes, 0, sizeof(MVMGen2SizeClass) * MVM_GEN2_BINS);
 
-    /* Set up overflows area. */
-    al->alloc_overflows = MVM_GEN2_OVERFLOWS;
-    al->num_overflows = 0;
-    al->overflows = malloc(al->alloc_overflows * sizeof(MVMCollectable *));
+    /* Large object space starts out empty. */
+    al->large_objects = NULL;
+    al->large_bytes   = 0;
+
+    al->promoted_bytes = 0;
 
     return al;
 }
 
+/* Gets memory for a page straight from the operating system, so that it can
+ * be handed back again if the page ever becomes entirely free. */
+static char * alloc_page_memory(MVMuint32 page_size) {
+    char *page = MVM_platform_alloc_pages(page_size, MVM_PAGE_READ | MVM_PAGE_WRITE);
+    if (!page)
+        MVM_panic(MVM_exitcode_gcalloc, "Failed to allocate gen2 page of %u bytes", page_size);
+    return page;
+}
+
 /* Sets up a size class bin in the second generation. */
 static void setup_bin(MVMGen2Allocator *al, MVMuint32 bin) {
     /* Work out page size we want. */
@@ -25,7 +36,7 @@ static void setup_bin(MVMGen2Allocator *al, MVMuint32 bin) {
     /* We'll just allocate a single page to start off with. */
     al->size_classes[bin].num_pages = 1;
     al->size_classes[bin].pages     = malloc(sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[0]  = malloc(page_size);
+    al->size_classes[bin].pages[0]  = alloc_page_memory(page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[0];
@@ -45,7 +56,7 @@ static void add_page(MVMGen2Allocator *al, MVMuint32 bin) {
     al->size_classes[bin].num_pages++;
     al->size_classes[bin].pages = realloc(al->size_classes[bin].pages,
         sizeof(void *) * al->size_classes[bin].num_pages);
-    al->size_classes[bin].pages[cur_page] = malloc(page_size);
+    al->size_classes[bin].pages[cur_page] = alloc_page_memory(page_size);
 
     /* Set up allocation position and limit. */
     al->size_classes[bin].alloc_pos = al->size_classes[bin].pages[cur_page];
@@ -55,10 +66,42 @@ static void add_page(MVMGen2Allocator *al, MVMuint32 bin) {
     al->size_classes[bin].cur_page = cur_page;
 }
 
+/* Allocates an object in the large object space. */
+static void * allocate_large(MVMGen2Allocator *al, MVMuint32 size) {
+    size_t              total = sizeof(MVMGen2LargeObject) + size;
+    MVMGen2LargeObject *lo    = malloc(total);
+    if (!lo)
+        MVM_panic(MVM_exitcode_gcalloc, "Failed to allocate large object of %u bytes", size);
+    lo->size = total;
+    lo->prev = NULL;
+    lo->next = al->large_objects;
+    if (lo->next)
+        lo->next->prev = lo;
+    al->large_objects = lo;
+    al->large_bytes += total;
+    return MVM_GEN2_LARGE_OBJECT(lo);
+}
+
+/* Frees the memory of an object in the large object space, and takes it off
+ * the list. Any cleanup of the object itself must already be done. */
+void MVM_gc_gen2_free_large(MVMGen2Allocator *al, MVMCollectable *col) {
+    MVMGen2LargeObject *lo = MVM_GEN2_LARGE_HEADER(col);
+    if (lo->prev)
+        lo->prev->next = lo->next;
+    else
+        al->large_objects = lo->next;
+    if (lo->next)
+        lo->next->prev = lo->prev;
+    al->large_bytes -= lo->size;
+    free(lo);
+}
+
 /* Allocates space using the second generation allocator and returns
  * a pointer to the allocated space. Does not zero the space or set
- * it up in any way. */
-void * MVM_gc_gen2_allocate(MVMGen2Allocator *al, MVMuint32 size) {
+ * it up in any way. If the size class still has pages waiting to be
+ * swept since the last full collection, we sweep those to find a free
+ * slot before growing. */
+void * MVM_gc_gen2_allocate(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 size) {
     void *result;
 
     /* Determine the bin. If we hit a bin exactly then it's off-by-one,
@@ -68,16 +111,32 @@ void * MVM_gc_gen2_allocate(MVMGen2Allocator *al, MVMuint32 size) {
     if ((size & MVM_GEN2_BIN_MASK) == 0)
         bin--;
 
+    /* Keep track of how much gen2 is growing. */
+    al->promoted_bytes += size;
+
     /* If the selected bin is in range... */
     if (bin < MVM_GEN2_BINS) {
         /* If we've no pages yet, never encountered this bin; set it up. */
         if (al->size_classes[bin].pages == NULL)
             setup_bin(al, bin);
 
+        /* If the free list is empty, lazily sweep until we find some free
+         * slots or there is nothing left to sweep. */
+        while (!al->size_classes[bin].free_list
+                && al->size_classes[bin].sweep_page < al->size_classes[bin].sweep_num_pages)
+            MVM_gc_collect_sweep_gen2_page(tc, bin);
+
+        al->size_classes[bin].used_items++;
+
         /* If there's a free list entry, use that. */
         if (al->size_classes[bin].free_list) {
             result = (void *)al->size_classes[bin].free_list;
             al->size_classes[bin].free_list = (char **)*(al->size_classes[bin].free_list);
+
+            /* If a sweep is adding to the end of the free list and we just
+             * took that end, it must start again from the head. */
+            if (al->size_classes[bin].free_list_tail == (char ***)result)
+                al->size_classes[bin].free_list_tail = &al->size_classes[bin].free_list;
         }
         else {
             /* If we're at the page limit, add a new page. */
@@ -90,16 +149,8 @@ void * MVM_gc_gen2_allocate(MVMGen2Allocator *al, MVMuint32 size) {
         }
     }
     else {
-        /* We're beyond the size class bins, so resort to malloc. */
-        result = malloc(size);
-
-        /* Add to overflows list. */
-        if (al->num_overflows == al->alloc_overflows) {
-            al->alloc_overflows *= 2;
-            al->overflows = realloc(al->overflows,
-                al->alloc_overflows * sizeof(MVMCollectable *));
-        }
-        al->overflows[al->num_overflows++] = result;
+        /* We're beyond the size class bins, so it's a large object. */
+        result = allocate_large(al, size);
     }
 
     return result;
@@ -108,8 +159,8 @@ void * MVM_gc_gen2_allocate(MVMGen2Allocator *al, MVMuint32 size) {
 /* Allocates space using the second generation allocator and returns
  * a pointer to the allocated space. Promises the memory will be
  * zeroed, except that the MVMCollectable gen 2 flag will get set. */
-void * MVM_gc_gen2_allocate_zeroed(MVMGen2Allocator *al, MVMuint32 size) {
-    void *a = MVM_gc_gen2_allocate(al, size);
+void * MVM_gc_gen2_allocate_zeroed(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 size) {
+    void *a = MVM_gc_gen2_allocate(tc, al, size);
     memset(a, 0, size);
     ((MVMCollectable *)a)->flags = MVM_CF_SECOND_GEN;
     return a;
@@ -121,30 +172,56 @@ void MVM_gc_gen2_destroy(MVMInstance *i, MVMGen2Allocator *al) {
 
     /* Remove all pages. */
     for (j = 0; j < MVM_GEN2_BINS; j++) {
+        MVMuint32 page_size = MVM_GEN2_PAGE_ITEMS * ((j + 1) << MVM_GEN2_BIN_BITS);
         for (k = 0; k < al->size_classes[j].num_pages; k++)
-            free(al->size_classes[j].pages[k]);
+            MVM_platform_free_pages(al->size_classes[j].pages[k], page_size);
         free(al->size_classes[j].pages);
     }
 
-    /* Free any allocated overflows. */
-    for (j = 0; j < al->num_overflows; j++)
-        if (al->overflows[j])
-            free(al->overflows[j]);
+    /* Free any large objects. */
+    while (al->large_objects)
+        MVM_gc_gen2_free_large(al, MVM_GEN2_LARGE_OBJECT(al->large_objects));
 
     /* Clean up allocator data structure. */
     free(al->size_classes);
     al->size_classes = NULL;
-    free(al->overflows);
-    al->overflows = NULL;
     free(al);
 }
 
+/* Hands a page of a size class that the sweep found to hold nothing live back
+ * to the operating system, and removes it from the page list. The page must
+ * not be the one we are currently bump-allocating in, and none of its slots
+ * may be on the free list. */
+void MVM_gc_gen2_release_page(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 bin, MVMuint32 page) {
+    MVMGen2SizeClass *sc        = &al->size_classes[bin];
+    MVMuint32         page_size = MVM_GEN2_PAGE_ITEMS * ((bin + 1) << MVM_GEN2_BIN_BITS);
+
+    if (page + 1 >= sc->num_pages)
+        MVM_panic(MVM_exitcode_gcalloc, "Cannot release the current gen2 allocation page");
+
+    MVM_platform_free_pages(sc->pages[page], page_size);
+    memmove(&sc->pages[page], &sc->pages[page + 1],
+        (sc->num_pages - page - 1) * sizeof(char *));
+    sc->num_pages--;
+    if (page < sc->cur_page)
+        sc->cur_page--;
+    if (page < sc->sweep_num_pages)
+        sc->sweep_num_pages--;
+
+    MVM_add(&tc->instance->gc_released_bytes, page_size);
+}
+
 /* blindly move pages from one gen2 to another */
 void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest) {
     MVMGen2Allocator *gen2 = src->gen2, *dest_gen2 = dest->gen2;
     MVMuint32 bin, obj_size, page;
     char ***freelist_insert_pos;
 
+    /* The free lists must be complete and in page order for us to merge
+     * them, so finish any sweeping that is still pending. */
+    MVM_gc_collect_finish_gen2_sweep(src);
+    MVM_gc_collect_finish_gen2_sweep(dest);
+
     for (bin = 0; bin < MVM_GEN2_BINS; bin++) {
         MVMuint32 orig_dest_num_pages = dest_gen2->size_classes[bin].num_pages;
         char *cur_ptr, *end_ptr;
@@ -226,42 +303,45 @@ void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest) {
         dest_gen2->size_classes[bin].alloc_pos = gen2->size_classes[bin].alloc_pos;
         dest_gen2->size_classes[bin].alloc_limit = gen2->size_classes[bin].alloc_limit;
 
+        dest_gen2->size_classes[bin].used_items += gen2->size_classes[bin].used_items;
+
         free(gen2->size_classes[bin].pages);
         gen2->size_classes[bin].pages = NULL;
         gen2->size_classes[bin].num_pages = 0;
+        gen2->size_classes[bin].used_items = 0;
     }
-    { /* copy the roots... */
-        MVMuint32 i, n = src->num_gen2roots;
-        for ( i = 0; i < n; i++) {
-            MVM_gc_root_gen2_add(dest, src->gen2roots[i]);
+    { /* move the large objects over... */
+        MVMGen2LargeObject *lo = gen2->large_objects, *last = NULL;
+        while (lo) {
+            MVM_GEN2_LARGE_OBJECT(lo)->owner = dest->thread_id;
+            last = lo;
+            lo = lo->next;
         }
+        if (last) {
+            last->next = dest_gen2->large_objects;
+            if (last->next)
+                last->next->prev = last;
+            dest_gen2->large_objects = gen2->large_objects;
+            dest_gen2->large_bytes  += gen2->large_bytes;
+            gen2->large_objects = NULL;
+            gen2->large_bytes   = 0;
+        }
+    }
+    { /* copy the roots; they are already flagged as being on a list, so
+       * append them directly rather than through MVM_gc_root_gen2_add. */
+        MVMuint32 n = src->num_gen2roots;
+        if (dest->num_gen2roots + n > dest->alloc_gen2roots) {
+            while (dest->num_gen2roots + n > dest->alloc_gen2roots)
+                dest->alloc_gen2roots *= 2;
+            dest->gen2roots = realloc(dest->gen2roots,
+                sizeof(MVMCollectable **) * dest->alloc_gen2roots);
+        }
+        memcpy(dest->gen2roots + dest->num_gen2roots, src->gen2roots,
+            sizeof(MVMCollectable **) * n);
+        dest->num_gen2roots += n;
         src->num_gen2roots = 0;
         src->alloc_gen2roots = 0;
         free(src->gen2roots);
         src->gen2roots = NULL;
     }
 }
-
-
-void MVM_gc_gen2_compact_overflows(MVMGen2Allocator *al) {
-    /* compact the overflow list to prevent it from growing without bounds */
-    MVMCollectable **overflows     = al->overflows;
-    const MVMuint32  num_overflows = al->num_overflows;
-    MVMuint32        cursor = 0;
-    MVMuint32        live;
-
-    /* Find the first NULL object. */
-    while (cursor < num_overflows && overflows[cursor])
-        cursor++;
-    live = cursor;
-
-    /* Slide others back so the alive ones are at the start of the list. */
-    while (cursor < num_overflows) {
-        if (overflows[cursor]) {
-            overflows[live++] = overflows[cursor];
-        }
-        cursor++;
-    }
-
-    al->num_overflows = live;
-}
@@ -20,6 +20,20 @@ struct MVMGen2SizeClass {
 
     /* The number of pages allocated. */
     MVMuint32 num_pages;
+
+    /* Lazy sweeping state. After a full collection marks, the pages below
+     * sweep_num_pages need sweeping, and sweep_page is the next one to do.
+     * Meanwhile, the free list only holds slots from swept pages, and is
+     * added to at free_list_tail; sweep_free_list is what remains of the
+     * old free list, whose slots are picked up again as the sweep reaches
+     * them. */
+    MVMuint32 sweep_page;
+    MVMuint32 sweep_num_pages;
+    char    **sweep_free_list;
+    char   ***free_list_tail;
+
+    /* The number of slots allocated and not yet swept up as free. */
+    MVMuint64 used_items;
 };
 
 /* An "instance" of the fixed size allocator. */
@@ -30,17 +44,36 @@ struct MVMGen2Allocator {
      * past the limit. */
     MVMGen2SizeClass *size_classes;
 
-    /* Array of objects that were malloc'd instead, because they did
-     * not fit in a size class due to being too large. */
-    MVMCollectable **overflows;
+    /* The large object space: objects too big for any size class, each
+     * allocated by itself and kept on a doubly linked list, so they can be
+     * freed in constant time. */
+    MVMGen2LargeObject *large_objects;
+
+    /* The number of bytes of large objects, including their headers. */
+    MVMuint64           large_bytes;
+
+    /* Bytes allocated here (by promotion or otherwise) since the last GC
+     * run; used to decide when a full collection is due. */
+    MVMuint64        promoted_bytes;
+};
+
+/* The header in front of each object in the large object space. The object
+ * itself follows straight after it. */
+struct MVMGen2LargeObject {
+    MVMGen2LargeObject *prev;
+    MVMGen2LargeObject *next;
 
-    /* The number of objects in the overflow array. */
-    MVMuint32        num_overflows;
+    /* Size of the whole allocation, header included. */
+    size_t              size;
 
-    /* The amount of space allocated in the overflow array. */
-    MVMuint32        alloc_overflows;
+    /* Keeps the object that follows 16-byte aligned. */
+    size_t              padding;
 };
 
+/* Gets the collectable from a large object header, and vice versa. */
+#define MVM_GEN2_LARGE_OBJECT(lo) ((MVMCollectable *)((MVMGen2LargeObject *)(lo) + 1))
+#define MVM_GEN2_LARGE_HEADER(col) ((MVMGen2LargeObject *)(col) - 1)
+
 /* The number of bits we discard from the requested size when binning
  * the allocation request into a size class. For example, if this is
  * 3 bits then:
@@ -58,16 +91,15 @@ struct MVMGen2Allocator {
 /* Number of bins in the FSA. Beyond this, we just degrade to malloc/free. */
 #define MVM_GEN2_BINS       32
 
-/* Default overflow list size. */
-#define MVM_GEN2_OVERFLOWS  32
-
-/* The number of items that go into each page. */
-#define MVM_GEN2_PAGE_ITEMS 256
+/* The number of items that go into each page. This makes every page a whole
+ * number of 4KB OS pages, so empty ones can be given back to the OS. */
+#define MVM_GEN2_PAGE_ITEMS 512
 
 /* Functions. */
 MVMGen2Allocator * MVM_gc_gen2_create(MVMInstance *i);
-void * MVM_gc_gen2_allocate(MVMGen2Allocator *al, MVMuint32 size);
-void * MVM_gc_gen2_allocate_zeroed(MVMGen2Allocator *al, MVMuint32 size);
+void * MVM_gc_gen2_allocate(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 size);
+void * MVM_gc_gen2_allocate_zeroed(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 size);
 void MVM_gc_gen2_destroy(MVMInstance *i, MVMGen2Allocator *allocator);
+void MVM_gc_gen2_release_page(MVMThreadContext *tc, MVMGen2Allocator *al, MVMuint32 bin, MVMuint32 page);
 void MVM_gc_gen2_transfer(MVMThreadContext *src, MVMThreadContext *dest);
-void MVM_gc_gen2_compact_overflows(MVMGen2Allocator *allocator);
+void MVM_gc_gen2_free_large(MVMGen2Allocator *al, MVMCollectable *col);
@@ -1,5 +1,6 @@
 #include "moar.h"
 #include <platform/threads.h>
+#include "platform/time.h"
 
 /* If we have the job of doing GC for a thread, we add it to our work
  * list. */
@@ -114,11 +115,60 @@ static int process_in_tray(MVMThreadContext *tc, MVMuint8 gen) {
     return 0;
 }
 
+/* Once all marking and copying is done, frees what was left behind in the
+ * nurseries of the threads we did GC work for, resizes them, and starts the
+ * lazy sweeps of their gen2. This must all happen before threads whose work
+ * we stole are released, since freeing goes through their FSA free list
+ * caches and their gen2, which they use without synchronization once they
+ * are running again. */
+static void free_garbage(MVMThreadContext *tc, MVMuint8 gen) {
+    MVMuint32 i;
+    for (i = 0; i < tc->gc_work_count; i++) {
+        MVMThreadContext *other = tc->gc_work[i].tc;
+
+        /* Collect nursery and gen2 as needed. */
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+            "Thread %d run %d : collecting nursery uncopied of thread %d\n",
+            other->thread_id);
+        MVM_gc_collect_free_nursery_uncopied(other, tc->gc_work[i].limit);
+        MVM_gc_collect_resize_nursery(other, tc->gc_work[i].limit);
+
+        /* Account for gen2 growth, so the co-ordinator can decide when the
+         * next full collection is due. Anything promoted during a full
+         * collection is already counted in the live bytes. */
+        if (gen == MVMGCGenerations_Both)
+            MVM_add(&tc->instance->gc_live_bytes, (AO_t)other->gc_live_bytes);
+        else
+            MVM_add(&tc->instance->gc_promoted_bytes, (AO_t)other->gen2->promoted_bytes);
+        other->gc_live_bytes       = 0;
+        other->gen2->promoted_bytes = 0;
+        if (gen == MVMGCGenerations_Both) {
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                "Thread %d run %d : starting lazy sweep of gen2 of thread %d\n",
+                other->thread_id);
+            MVM_gc_collect_start_gen2_sweep(other);
+        }
+    }
+}
+
 /* Called by a thread when it thinks it is done with GC. It may get some more
  * work yet, though. */
 static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinator) {
     MVMuint32 i, did_work;
 
+    /* In a full collection, help out any threads that still have a lot of
+     * gen2 marking to do by stealing work they offer up. */
+    if (gen == MVMGCGenerations_Both) {
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+            "Thread %d run %d : looking for marking work to steal\n");
+        MVM_incr(&tc->instance->gc_stealers);
+        while (MVM_load(&tc->instance->gc_marking)) {
+            if (!MVM_gc_collect_steal(tc))
+                MVM_platform_thread_yield();
+        }
+        MVM_decr(&tc->instance->gc_stealers);
+    }
+
     /* Do any extra work that we have been passed. */
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
         "Thread %d run %d : doing any work in thread in-trays\n");
@@ -163,7 +213,14 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
                     MVM_gc_root_gen2_cleanup(cur_thread->body.tc);
                 cur_thread = cur_thread->body.next;
             }
+
+            /* Nobody else is touching the FSA right now, so it is a good
+             * time to give its empty pages back, if it has a lot of free
+             * slots. */
+            MVM_fixed_size_release_free_pages(tc, tc->instance->fsa);
         }
+        MVM_string_intern_sweep(tc, gen);
+        MVM_gc_stats_snapshot_heap(tc);
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
             "Thread %d run %d : Co-ordinator signalling in-trays clear\n");
         MVM_store(&tc->instance->gc_intrays_clearing, 0);
@@ -178,6 +235,9 @@ static void finish_gc(MVMThreadContext *tc, MVMuint8 gen, MVMuint8 is_coordinato
             "Thread %d run %d : Got in-tray clearing complete notice\n");
     }
 
+    /* Now we're all done, it's safe to finalize any objects that need it. */
+    free_garbage(tc, gen);
+
     /* Reset GC status flags. This is also where thread destruction happens,
      * and it needs to happen before we acknowledge this GC run is finished. */
     for (i = 0; i < tc->gc_work_count; i++) {
@@ -249,17 +309,44 @@ void MVM_gc_mark_thread_unblocked(MVMThreadContext *tc) {
     }
 }
 
+/* Decides if a full collection is due: that is, if gen2 has grown by enough
+ * since the last one, relative to how much was live in it then. */
+static MVMuint8 is_full_collection_due(MVMThreadContext *tc) {
+    MVMInstance *i         = tc->instance;
+    AO_t         promoted  = MVM_load(&i->gc_promoted_bytes);
+    AO_t         threshold = MVM_load(&i->gc_live_bytes) / 100 * i->gc_gen2_growth;
+    if (threshold < MVM_GC_GEN2_MIN_GROWTH)
+        threshold = MVM_GC_GEN2_MIN_GROWTH;
+    return promoted >= threshold;
+}
+
+/* Finishes any lazy gen2 sweeping left from the last full collection, for
+ * all the threads we're doing GC work for. */
+static void finish_gen2_sweeps(MVMThreadContext *tc) {
+    MVMuint32 i;
+    for (i = 0; i < tc->gc_work_count; i++) {
+        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+            "Thread %d run %d : finishing gen2 sweep of thread %d\n",
+            tc->gc_work[i].tc->thread_id);
+        MVM_gc_collect_finish_gen2_sweep(tc->gc_work[i].tc);
+    }
+}
+
 static void run_gc(MVMThreadContext *tc, MVMuint8 what_to_do) {
     MVMuint8   gen;
     MVMThread *child;
     MVMuint32  i, n;
 
-    /* Decide nursery or full collection. */
-    gen = MVM_load(&tc->instance->gc_seq_number) % MVM_GC_GEN2_RATIO == 0
+    /* Nursery or full collection, as the co-ordinator decided. */
+    gen = MVM_load(&tc->instance->gc_full_collect)
         ? MVMGCGenerations_Both
         : MVMGCGenerations_Nursery;
 
-    /* Do GC work for ourselve and any work threads. */
+    /* Do GC work for ourselve and any work threads. In a full collection,
+     * count ourselves as marking until we're done, so threads that finish
+     * sooner know there may be work to steal. */
+    if (gen == MVMGCGenerations_Both)
+        MVM_incr(&tc->instance->gc_marking);
     for (i = 0, n = tc->gc_work_count ; i < n; i++) {
         MVMThreadContext *other = tc->gc_work[i].tc;
         tc->gc_work[i].limit = other->nursery_alloc;
@@ -267,33 +354,11 @@ static void run_gc(MVMThreadContext *tc, MVMuint8 what_to_do) {
             other->thread_id);
         MVM_gc_collect(other, (other == tc ? what_to_do : MVMGCWhatToDo_NoInstance), gen);
     }
+    if (gen == MVMGCGenerations_Both)
+        MVM_decr(&tc->instance->gc_marking);
 
     /* Wait for everybody to agree we're done. */
     finish_gc(tc, gen, what_to_do == MVMGCWhatToDo_All);
-
-    /* Now we're all done, it's safe to finalize any objects that need it. */
-	/* XXX TODO explore the feasability of doing this in a background
-	 * finalizer/destructor thread and letting the main thread(s) continue
-	 * on their merry way(s). */
-    for (i = 0, n = tc->gc_work_count ; i < n; i++) {
-        MVMThreadContext *other = tc->gc_work[i].tc;
-
-        /* The thread might've been destroyed */
-        if (!other)
-            continue;
-
-        /* Collect nursery and gen2 as needed. */
-        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
-            "Thread %d run %d : collecting nursery uncopied of thread %d\n",
-            other->thread_id);
-        MVM_gc_collect_free_nursery_uncopied(other, tc->gc_work[i].limit);
-        if (gen == MVMGCGenerations_Both) {
-            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
-                "Thread %d run %d : freeing gen2 of thread %d\n",
-                other->thread_id);
-            MVM_gc_collect_free_gen2_unmarked(other);
-        }
-    }
 }
 
 /* This is called when the allocator finds it has run out of memory and wants
@@ -308,6 +373,7 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
     if (MVM_trycas(&tc->instance->gc_start, 0, 1)) {
         MVMThread *last_starter = NULL;
         MVMuint32 num_threads = 0;
+        MVMuint64 start = MVM_platform_now();
 
         /* Need to wait for other threads to reset their gc_status. */
         while (MVM_load(&tc->instance->gc_ack)) {
@@ -324,6 +390,20 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
             "Thread %d run %d : GC thread elected coordinator: starting gc seq %d\n",
             (int)MVM_load(&tc->instance->gc_seq_number));
 
+        /* Decide if this will be a full collection. This must happen before
+         * we signal other threads, since they need to know too. */
+        if (is_full_collection_due(tc)) {
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE,
+                "Thread %d run %d : gen2 grew by %d bytes; doing a full collection\n",
+                (int)MVM_load(&tc->instance->gc_promoted_bytes));
+            MVM_store(&tc->instance->gc_promoted_bytes, 0);
+            MVM_store(&tc->instance->gc_live_bytes, 0);
+            MVM_store(&tc->instance->gc_full_collect, 1);
+        }
+        else {
+            MVM_store(&tc->instance->gc_full_collect, 0);
+        }
+
         /* Ensure our stolen list is empty. */
         tc->gc_work_count = 0;
 
@@ -367,6 +447,11 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : finish votes is %d\n",
             (int)MVM_load(&tc->instance->gc_finish));
 
+        /* Before a full collection, finish sweeping gen2 from last time for
+         * ourself and any threads whose work we stole. */
+        if (MVM_load(&tc->instance->gc_full_collect))
+            finish_gen2_sweeps(tc);
+
         /* Signal to the rest to start */
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : coordinator signalling start\n");
         if (MVM_decr(&tc->instance->gc_start) != 1)
@@ -376,11 +461,16 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : coordinator entering run_gc\n");
         run_gc(tc, MVMGCWhatToDo_All);
 
-        /* Free any STables that have been marked for deletion. It's okay for
-         * us to muck around in another thread's fromspace while it's mutating
-         * tospace, really. */
-        GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Freeing STables if needed\n");
-        MVM_gc_collect_free_stables(tc);
+        /* Free any STables that have been marked for deletion and that no
+         * object awaiting a lazy gen2 sweep can still refer to; we can only
+         * be sure of that after a full collection. */
+        if (MVM_load(&tc->instance->gc_full_collect)) {
+            GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Freeing STables if needed\n");
+            MVM_gc_collect_free_swept_stables(tc);
+        }
+
+        /* Record how the run went. */
+        MVM_gc_stats_record(tc, start, 1);
 
         GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : GC complete (cooridnator)\n");
     }
@@ -396,6 +486,7 @@ void MVM_gc_enter_from_allocator(MVMThreadContext *tc) {
  * that another thread is already trying to start a GC run, so we don't need to
  * try and do that, just enlist in the run. */
 void MVM_gc_enter_from_interrupt(MVMThreadContext *tc) {
+    MVMuint64 start = MVM_platform_now();
     AO_t curr;
 
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Entered from interrupt\n");
@@ -404,6 +495,14 @@ void MVM_gc_enter_from_interrupt(MVMThreadContext *tc) {
     tc->gc_work_count = 0;
     add_work(tc, tc);
 
+    /* Wait until the co-ordinator has counted us in; after that we know if
+     * this will be a full collection, in which case we must finish sweeping
+     * our gen2 from last time before anyone starts marking. */
+    while (MVM_load(&tc->instance->gc_start) < 2)
+        MVM_platform_thread_yield();
+    if (MVM_load(&tc->instance->gc_full_collect))
+        finish_gen2_sweeps(tc);
+
     /* Indicate that we're ready to GC. Only want to decrement it if it's 2 or
      * greater (0 should never happen; 1 means the coordinator is still counting
      * up how many threads will join in, so we should wait until it decides to
@@ -421,12 +520,14 @@ void MVM_gc_enter_from_interrupt(MVMThreadContext *tc) {
 
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : Entering run_gc\n");
     run_gc(tc, MVMGCWhatToDo_NoInstance);
+    MVM_gc_stats_record(tc, start, 0);
     GCDEBUG_LOG(tc, MVM_GC_DEBUG_ORCHESTRATE, "Thread %d run %d : GC complete\n");
 }
 
 /* Run the global destruction phase. */
 void MVM_gc_global_destruction(MVMThreadContext *tc) {
     char *nursery_tmp;
+    MVMuint32 nursery_size_tmp;
 
     /* Must wait until we're the only thread... */
     while (tc->instance->num_user_threads) {
@@ -439,6 +540,9 @@ void MVM_gc_global_destruction(MVMThreadContext *tc) {
     nursery_tmp = tc->nursery_fromspace;
     tc->nursery_fromspace = tc->nursery_tospace;
     tc->nursery_tospace = nursery_tmp;
+    nursery_size_tmp = tc->nursery_fromspace_size;
+    tc->nursery_fromspace_size = tc->nursery_tospace_size;
+    tc->nursery_tospace_size = nursery_size_tmp;
 
     /* Run the objects' finalizers */
     MVM_gc_collect_free_nursery_uncopied(tc, tc->nursery_alloc);
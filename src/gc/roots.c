@@ -108,6 +108,7 @@ void MVM_gc_root_add_tc_roots_to_worklist(MVMThreadContext *tc, MVMGCWorklist *w
     HASH_ITER(hash_handle, tc->native_callback_cache, current_cbceh, tmp_cbceh) {
         MVMint32 i;
         MVMNativeCallback *entry = current_cbceh->head;
+        MVM_gc_worklist_add(tc, worklist, &current_cbceh->cuid);
         while (entry) {
             for (i = 0; i < entry->num_types; i++)
                 MVM_gc_worklist_add(tc, worklist, &(entry->types[i]));
@@ -189,6 +190,10 @@ void MVM_gc_root_gen2_add(MVMThreadContext *tc, MVMCollectable *c) {
         MVM_panic(MVM_exitcode_gcroots, "Illegal attempt to add null collectable address as an inter-generational root");
     assert(!(c->flags & MVM_CF_FORWARDER_VALID));
 
+    /* Already on the list; adding it again would leave it there twice. */
+    if (c->flags & MVM_CF_IN_GEN2_ROOT_LIST)
+        return;
+
     /* Allocate extra gen2 aggregate space if needed. */
     if (tc->num_gen2roots == tc->alloc_gen2roots) {
         tc->alloc_gen2roots *= 2;
@@ -0,0 +1,204 @@
+#include "moar.h"
+#include "platform/time.h"
+
+/* Called by the GC co-ordinator near the end of a run, while it still owns
+ * all the threads, to take a snapshot of the heap for MVM_gc_stats; doing it
+ * any other time would mean reading other threads' allocators while they
+ * use them. */
+void MVM_gc_stats_snapshot_heap(MVMThreadContext *tc) {
+    MVMInstance    *instance = tc->instance;
+    MVMGCHeapStats *heap     = instance->gc_stats_heap;
+    MVMThread      *cur_thread;
+    MVMuint32       i;
+
+    if (!heap)
+        heap = instance->gc_stats_heap = malloc(sizeof(MVMGCHeapStats));
+    memset(heap, 0, sizeof(MVMGCHeapStats));
+    cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    while (cur_thread) {
+        MVMThreadContext *thread_tc = cur_thread->body.tc;
+        if (thread_tc) {
+            MVMGen2Allocator *gen2 = thread_tc->gen2;
+            heap->nursery_used += (char *)thread_tc->nursery_alloc
+                - (char *)thread_tc->nursery_tospace;
+            heap->nursery_capacity += thread_tc->nursery_tospace_size;
+            for (i = 0; i < MVM_GEN2_BINS; i++) {
+                MVMuint64 obj_size = (i + 1) << MVM_GEN2_BIN_BITS;
+                heap->gen2_used[i]     += gen2->size_classes[i].used_items * obj_size;
+                heap->gen2_capacity[i] += (MVMuint64)gen2->size_classes[i].num_pages
+                    * MVM_GEN2_PAGE_ITEMS * obj_size;
+            }
+            heap->gen2_large += gen2->large_bytes;
+        }
+        cur_thread = cur_thread->body.next;
+    }
+}
+
+/* Called by each thread that took part in a GC run once it is done, with
+ * the time it entered the GC. Adds what happened in the nurseries it worked
+ * on to the instance totals, and writes a line to the stats log if there is
+ * one. The co-ordinator also records when the run started and ended. */
+void MVM_gc_stats_record(MVMThreadContext *tc, MVMuint64 start, MVMuint8 is_coordinator) {
+    MVMInstance *instance = tc->instance;
+    MVMuint64    end      = MVM_platform_now();
+    MVMuint64    pause    = end - start;
+    MVMuint64    copied   = 0;
+    MVMuint64    promoted = 0;
+    MVMuint8     full     = (MVMuint8)MVM_load(&instance->gc_full_collect);
+    MVMuint32    i;
+
+    /* Gather the bytes moved in our own nursery and those of any blocked
+     * threads we did the work for. */
+    for (i = 0; i < tc->gc_work_count; i++) {
+        MVMThreadContext *other = tc->gc_work[i].tc;
+        if (!other)
+            continue;
+        copied   += other->gc_stats_copied;
+        promoted += other->gc_stats_promoted;
+        other->gc_stats_copied   = 0;
+        other->gc_stats_promoted = 0;
+    }
+
+    tc->gc_stats_runs++;
+    tc->gc_stats_last_pause = pause;
+    tc->gc_stats_pause     += pause;
+    MVM_add(&instance->gc_stats_pause, (AO_t)pause);
+    MVM_add(&instance->gc_stats_copied, (AO_t)copied);
+    MVM_add(&instance->gc_stats_promoted, (AO_t)promoted);
+    MVM_add(&instance->gc_stats_stolen, (AO_t)tc->gc_stats_stolen);
+
+    if (is_coordinator) {
+        MVM_incr(&instance->gc_stats_runs);
+        if (full)
+            MVM_incr(&instance->gc_stats_full_runs);
+        instance->gc_stats_last_start = start;
+        instance->gc_stats_last_end   = end;
+    }
+
+    if (instance->gc_stats_fh) {
+        uv_mutex_lock(&instance->mutex_gc_stats_log);
+        fprintf(instance->gc_stats_fh,
+            "run=%u thread=%u full=%u start=%llu pause=%llu copied=%llu promoted=%llu stolen=%u\n",
+            (MVMuint32)MVM_load(&instance->gc_seq_number), tc->thread_id, full,
+            (unsigned long long)start, (unsigned long long)pause,
+            (unsigned long long)copied, (unsigned long long)promoted,
+            tc->gc_stats_stolen);
+        uv_mutex_unlock(&instance->mutex_gc_stats_log);
+    }
+
+    tc->gc_stats_stolen = 0;
+}
+
+/* Statistics about one thread, snapshotted before we start allocating the
+ * result (which may trigger a GC run and so change them). */
+typedef struct {
+    MVMuint32 thread_id;
+    MVMuint32 runs;
+    MVMuint64 last_pause;
+    MVMuint64 pause;
+} ThreadStats;
+
+/* Boxes an integer and binds it under the given key in a hash. */
+static void bind_int(MVMThreadContext *tc, MVMObject *hash, const char *key, MVMint64 value) {
+    MVMObject *boxed;
+    MVMString *key_str;
+    MVMROOT(tc, hash, {
+        boxed = MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, value);
+        MVMROOT(tc, boxed, {
+            key_str = MVM_string_ascii_decode_nt(tc, tc->instance->VMString, key);
+        });
+    });
+    MVM_repr_bind_key_o(tc, hash, key_str, boxed);
+}
+
+/* Builds a hash of GC statistics: totals over all runs so far, the start and
+ * end of the latest run, the nursery and gen2 bytes in use and allocated as
+ * of the end of the latest run (gen2 per size class), and per-thread pause
+ * times. */
+MVMObject * MVM_gc_stats(MVMThreadContext *tc) {
+    MVMInstance    *instance = tc->instance;
+    MVMGCHeapStats  heap;
+    ThreadStats    *threads;
+    MVMuint32       num_threads = 0, alloc_threads = 8, i;
+    MVMObject      *result = NULL, *used = NULL, *capacity = NULL;
+    MVMObject      *thread_list = NULL, *thread_hash = NULL, *boxed = NULL;
+    MVMString      *key = NULL;
+    MVMThread      *cur_thread;
+
+    /* Copy the heap snapshot and each thread's pause times first; nothing
+     * here allocates, so no GC run can happen (and no thread go away, or the
+     * snapshot change) underneath us. */
+    if (instance->gc_stats_heap)
+        heap = *instance->gc_stats_heap;
+    else
+        memset(&heap, 0, sizeof(MVMGCHeapStats));
+    threads    = malloc(alloc_threads * sizeof(ThreadStats));
+    cur_thread = (MVMThread *)MVM_load(&instance->threads);
+    while (cur_thread) {
+        MVMThreadContext *thread_tc = cur_thread->body.tc;
+        if (thread_tc) {
+            if (num_threads == alloc_threads) {
+                alloc_threads *= 2;
+                threads = realloc(threads, alloc_threads * sizeof(ThreadStats));
+            }
+            threads[num_threads].thread_id  = thread_tc->thread_id;
+            threads[num_threads].runs       = thread_tc->gc_stats_runs;
+            threads[num_threads].last_pause = thread_tc->gc_stats_last_pause;
+            threads[num_threads].pause      = thread_tc->gc_stats_pause;
+            num_threads++;
+        }
+        cur_thread = cur_thread->body.next;
+    }
+
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&result);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&used);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&capacity);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&thread_list);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&thread_hash);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&boxed);
+    MVM_gc_root_temp_push(tc, (MVMCollectable **)&key);
+
+    result = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_hash_type);
+    bind_int(tc, result, "runs", MVM_load(&instance->gc_stats_runs));
+    bind_int(tc, result, "full_runs", MVM_load(&instance->gc_stats_full_runs));
+    bind_int(tc, result, "last_start", instance->gc_stats_last_start);
+    bind_int(tc, result, "last_end", instance->gc_stats_last_end);
+    bind_int(tc, result, "pause", MVM_load(&instance->gc_stats_pause));
+    bind_int(tc, result, "copied_bytes", MVM_load(&instance->gc_stats_copied));
+    bind_int(tc, result, "promoted_bytes", MVM_load(&instance->gc_stats_promoted));
+    bind_int(tc, result, "stolen_work", MVM_load(&instance->gc_stats_stolen));
+    bind_int(tc, result, "released_bytes", MVM_load(&instance->gc_released_bytes));
+    bind_int(tc, result, "nursery_used_bytes", heap.nursery_used);
+    bind_int(tc, result, "nursery_capacity_bytes", heap.nursery_capacity);
+    bind_int(tc, result, "gen2_large_bytes", heap.gen2_large);
+
+    used     = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
+    capacity = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
+    for (i = 0; i < MVM_GEN2_BINS; i++) {
+        boxed = MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, heap.gen2_used[i]);
+        MVM_repr_push_o(tc, used, boxed);
+        boxed = MVM_repr_box_int(tc, MVM_hll_current(tc)->int_box_type, heap.gen2_capacity[i]);
+        MVM_repr_push_o(tc, capacity, boxed);
+    }
+    key = MVM_string_ascii_decode_nt(tc, instance->VMString, "gen2_used_bytes");
+    MVM_repr_bind_key_o(tc, result, key, used);
+    key = MVM_string_ascii_decode_nt(tc, instance->VMString, "gen2_capacity_bytes");
+    MVM_repr_bind_key_o(tc, result, key, capacity);
+
+    thread_list = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_array_type);
+    for (i = 0; i < num_threads; i++) {
+        thread_hash = MVM_repr_alloc_init(tc, MVM_hll_current(tc)->slurpy_hash_type);
+        bind_int(tc, thread_hash, "id", threads[i].thread_id);
+        bind_int(tc, thread_hash, "runs", threads[i].runs);
+        bind_int(tc, thread_hash, "last_pause", threads[i].last_pause);
+        bind_int(tc, thread_hash, "pause", threads[i].pause);
+        MVM_repr_push_o(tc, thread_list, thread_hash);
+    }
+    key = MVM_string_ascii_decode_nt(tc, instance->VMString, "threads");
+    MVM_repr_bind_key_o(tc, result, key, thread_list);
+
+    MVM_gc_root_temp_pop_n(tc, 7);
+    free(threads);
+
+    return result;
+}
@@ -0,0 +1,16 @@
+/* A snapshot of how big the heap is and how much of it is in use, summed
+ * over all threads. Nursery use is what survived into tospace. A gen2 slot
+ * is in use unless it is on a free list, so that includes dead objects that
+ * are still waiting for a lazy sweep. */
+struct MVMGCHeapStats {
+    MVMuint64 nursery_used;
+    MVMuint64 nursery_capacity;
+    MVMuint64 gen2_used[MVM_GEN2_BINS];
+    MVMuint64 gen2_capacity[MVM_GEN2_BINS];
+    MVMuint64 gen2_large;
+};
+
+/* Functions for recording and reporting GC statistics. */
+void MVM_gc_stats_snapshot_heap(MVMThreadContext *tc);
+void MVM_gc_stats_record(MVMThreadContext *tc, MVMuint64 start, MVMuint8 is_coordinator);
+MVMObject * MVM_gc_stats(MVMThreadContext *tc);
@@ -1,4 +1,5 @@
 #include "moar.h"
+#include <platform/threads.h>
 
 /* Allocates a new GC worklist. */
 MVMGCWorklist * MVM_gc_worklist_create(MVMThreadContext *tc, MVMuint8 include_gen2) {
@@ -9,6 +10,7 @@ MVMGCWorklist * MVM_gc_worklist_create(MVMThreadContext *tc, MVMuint8 include_ge
     worklist->frames_alloc = MVM_GC_WORKLIST_START_SIZE;
     worklist->list  = malloc(worklist->alloc * sizeof(MVMCollectable **));
     worklist->frames_list  = malloc(worklist->frames_alloc * sizeof(MVMFrame *));
+    worklist->share_at = MVM_GC_WORKLIST_STEAL_THRESHOLD;
     worklist->include_gen2 = include_gen2;
     return worklist;
 }
@@ -56,3 +58,73 @@ void MVM_gc_worklist_mark_frame_roots(MVMThreadContext *tc, MVMGCWorklist *workl
         MVM_gc_root_add_frame_roots_to_worklist((tc), (worklist), cur_frame);
 }
 
+
+/* Locking for the chunks of work a thread has offered up for stealing. The
+ * work is handed around in chunks, so this sees little contention. */
+static void lock_shared(MVMThreadContext *tc) {
+    while (!MVM_trycas(&tc->gc_steal_lock, 0, 1))
+        MVM_platform_thread_yield();
+}
+static void unlock_shared(MVMThreadContext *tc) {
+    MVM_store(&tc->gc_steal_lock, 0);
+}
+
+/* Moves a chunk of the gen2 objects waiting to be marked off the top of the
+ * worklist, making them available for other threads to steal. Anything that
+ * is not in gen2 stays put, since only its owner may copy a nursery object. */
+void MVM_gc_worklist_share(MVMThreadContext *tc, MVMGCWorklist *worklist) {
+    MVMGCPassedWork *work  = calloc(1, sizeof(MVMGCPassedWork));
+    MVMuint32        start = worklist->items > MVM_GC_PASS_WORK_SIZE
+        ? worklist->items - MVM_GC_PASS_WORK_SIZE
+        : 0;
+    MVMuint32        keep  = start;
+    MVMuint32        k;
+
+    for (k = start; k < worklist->items; k++) {
+        MVMCollectable **item_ptr = worklist->list[k];
+        MVMCollectable  *item     = *item_ptr;
+        if (item && (item->flags & MVM_CF_SECOND_GEN) && !(item->flags & MVM_CF_GEN2_LIVE))
+            work->items[work->num_items++] = item_ptr;
+        else
+            worklist->list[keep++] = item_ptr;
+    }
+    worklist->items = keep;
+
+    /* If there was nothing to share, back off for a while before looking
+     * again, so we don't keep rescanning the same nursery items. */
+    if (work->num_items == 0) {
+        worklist->share_at = worklist->items + MVM_GC_WORKLIST_STEAL_THRESHOLD;
+        free(work);
+        return;
+    }
+    worklist->share_at = worklist->items + MVM_GC_PASS_WORK_SIZE;
+    if (worklist->share_at < MVM_GC_WORKLIST_STEAL_THRESHOLD)
+        worklist->share_at = MVM_GC_WORKLIST_STEAL_THRESHOLD;
+
+    lock_shared(tc);
+    work->next = tc->gc_steal_chunks;
+    tc->gc_steal_chunks = work;
+    unlock_shared(tc);
+}
+
+/* Takes a chunk of work that the specified thread offered up for stealing,
+ * if there is any. A thread also uses this to take back its own work that
+ * nobody stole. A thread stealing work is counted as marking before the
+ * work leaves its owner's list, so that the owner running out of work can
+ * never make it look as though all marking is done while the stolen work
+ * is still to do; the stealer must decrement gc_marking when finished. */
+MVMGCPassedWork * MVM_gc_worklist_take_shared(MVMThreadContext *tc, MVMThreadContext *from) {
+    MVMGCPassedWork *work;
+    if (!MVM_load(&from->gc_steal_chunks))
+        return NULL;
+    lock_shared(from);
+    work = from->gc_steal_chunks;
+    if (work) {
+        if (from != tc)
+            MVM_incr(&tc->instance->gc_marking);
+        from->gc_steal_chunks = work->next;
+        work->next = NULL;
+    }
+    unlock_shared(from);
+    return work;
+}
@@ -27,6 +27,10 @@ struct MVMGCWorklist {
     MVMuint32 alloc;
     MVMuint32 frames_alloc;
 
+    /* The number of items the worklist must reach before we consider
+     * offering some of them for other threads to steal. */
+    MVMuint32 share_at;
+
     /* Whether we should include gen2 entries. */
     MVMuint8 include_gen2;
 };
@@ -81,7 +85,14 @@ MVM_PUBLIC void MVM_gc_worklist_add_frame_slow(MVMThreadContext *tc, MVMGCWorkli
 void MVM_gc_worklist_presize_for(MVMThreadContext *tc, MVMGCWorklist *worklist, MVMint32 items);
 void MVM_gc_worklist_destroy(MVMThreadContext *tc, MVMGCWorklist *worklist);
 void MVM_gc_worklist_mark_frame_roots(MVMThreadContext *tc, MVMGCWorklist *worklist);
+void MVM_gc_worklist_share(MVMThreadContext *tc, MVMGCWorklist *worklist);
+MVMGCPassedWork * MVM_gc_worklist_take_shared(MVMThreadContext *tc, MVMThreadContext *from);
 
 /* The number of pointers we assume the list may need to hold initially;
  * it will be resized as needed. */
 #define MVM_GC_WORKLIST_START_SIZE      256
+
+/* During a full collection, once a worklist holds this many items and some
+ * other thread is idle, gen2 objects on it (which only need marking, and so
+ * can be handled by any thread) are offered up for stealing in chunks. */
+#define MVM_GC_WORKLIST_STEAL_THRESHOLD 256
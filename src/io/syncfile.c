@@ -34,6 +34,14 @@ typedef struct {
 
     /* Decode stream, for turning bytes from disk into strings. */
     MVMDecodeStream *ds;
+
+    /* Current separators to read lines up until. */
+    MVMDecodeStreamSeparators sep_spec;
+
+    /* Buffer that strings are encoded into for writing, kept between
+     * writes so long as it is no bigger than CHUNK_SIZE. */
+    MVMuint8 *write_buffer;
+    MVMuint64 write_buffer_size;
 } MVMIOFileData;
 
 /* Closes the file. */
@@ -84,9 +92,10 @@ static MVMint64 tell(MVMThreadContext *tc, MVMOSHandle *h) {
     return data->ds ? MVM_string_decodestream_tell_bytes(tc, data->ds) : 0;
 }
 
-/* Set the line separator. */
-static void set_separator(MVMThreadContext *tc, MVMOSHandle *h, MVMString *sep) {
-    MVM_exception_throw_adhoc(tc, "set_separator NYI on file handles");
+/* Set the line separators. */
+static void set_separator(MVMThreadContext *tc, MVMOSHandle *h, MVMString **seps, MVMint32 num_seps) {
+    MVMIOFileData *data = (MVMIOFileData *)h->body.data;
+    MVM_string_decodestream_sep_from_strings(tc, &(data->sep_spec), seps, num_seps);
 }
 
 /* Read a bunch of bytes into the current decode stream. */
@@ -117,7 +126,7 @@ static MVMString * read_line(MVMThreadContext *tc, MVMOSHandle *h) {
 
     /* Pull data until we can read a line. */
     do {
-        MVMString *line = MVM_string_decodestream_get_until_sep(tc, data->ds, '\n');
+        MVMString *line = MVM_string_decodestream_get_until_sep(tc, data->ds, &(data->sep_spec));
         if (line != NULL)
             return line;
     } while (read_to_buffer(tc, data, CHUNK_SIZE) > 0);
@@ -195,6 +204,29 @@ static MVMint64 eof(MVMThreadContext *tc, MVMOSHandle *h) {
     return req.statbuf.st_size == seek_pos;
 }
 
+/* Gets a buffer of at least the specified size to encode a string into
+ * for writing, reusing the handle's write buffer. */
+static MVMuint8 * get_write_buffer(MVMIOFileData *data, MVMuint64 size) {
+    if (size > data->write_buffer_size) {
+        data->write_buffer      = realloc(data->write_buffer, size);
+        data->write_buffer_size = size;
+    }
+    return data->write_buffer;
+}
+
+/* Done with the output of a string write. Frees it unless it is the write
+ * buffer; that is kept unless a big string made it grow past CHUNK_SIZE. */
+static void release_write_buffer(MVMIOFileData *data, MVMuint8 *output) {
+    if (output != data->write_buffer) {
+        free(output);
+    }
+    else if (data->write_buffer_size > CHUNK_SIZE) {
+        free(data->write_buffer);
+        data->write_buffer      = NULL;
+        data->write_buffer_size = 0;
+    }
+}
+
 /* Writes the specified string to the file handle, maybe with a newline. */
 static MVMint64 write_str(MVMThreadContext *tc, MVMOSHandle *h, MVMString *str, MVMint64 newline) {
     MVMIOFileData *data = (MVMIOFileData *)h->body.data;
@@ -202,19 +234,36 @@ static MVMint64 write_str(MVMThreadContext *tc, MVMOSHandle *h, MVMString *str,
     MVMint64 output_size, bytes_written;
     uv_fs_t req;
 
-    output = MVM_string_encode(tc, str, 0, -1, &output_size, data->encoding);
-    bytes_written = uv_fs_write(tc->loop, &req, data->fd, (const void *)output, output_size, -1, NULL);
-    if (bytes_written < 0) {
-        free(output);
-        MVM_exception_throw_adhoc(tc, "Failed to write bytes to filehandle: %s", uv_strerror(req.result));
+    /* Encodings that can say up front how big their output will be encode
+     * straight into the handle's write buffer; others get one allocated. */
+    switch (data->encoding) {
+        case MVM_encoding_type_utf8:
+            output = get_write_buffer(data,
+                MVM_string_utf8_encoded_size(tc, str, 0, -1) + 1);
+            output_size = MVM_string_utf8_encode_into(tc, str, 0, -1, output);
+            break;
+        case MVM_encoding_type_ascii:
+            output = get_write_buffer(data, MVM_string_graphs(tc, str) + 1);
+            output_size = MVM_string_ascii_encode_into(tc, str, 0, -1, output);
+            break;
+        case MVM_encoding_type_latin1:
+            output = get_write_buffer(data, MVM_string_graphs(tc, str) + 1);
+            output_size = MVM_string_latin1_encode_into(tc, str, 0, -1, output);
+            break;
+        default:
+            output = MVM_string_encode(tc, str, 0, -1, &output_size, data->encoding);
+            if (newline)
+                output = (MVMuint8 *)realloc(output, output_size + 1);
+            break;
     }
-    free(output);
-
     if (newline) {
-        if (uv_fs_write(tc->loop, &req, data->fd, "\n", 1, -1, NULL) < 0)
-            MVM_exception_throw_adhoc(tc, "Failed to write newline to filehandle: %s", uv_strerror(req.result));
-        bytes_written++;
+        /* Send the newline with the string, rather than in a write of its own. */
+        output[output_size++] = '\n';
     }
+    bytes_written = uv_fs_write(tc->loop, &req, data->fd, (const void *)output, output_size, -1, NULL);
+    release_write_buffer(data, output);
+    if (bytes_written < 0)
+        MVM_exception_throw_adhoc(tc, "Failed to write bytes to filehandle: %s", uv_strerror(req.result));
 
     return bytes_written;
 }
@@ -353,6 +402,9 @@ static void gc_free(MVMThreadContext *tc, MVMObject *h, void *d) {
             MVM_string_decodestream_destory(tc, data->ds);
         if (data->filename)
             free(data->filename);
+        if (data->write_buffer)
+            free(data->write_buffer);
+        MVM_string_decodestream_sep_destroy(tc, &(data->sep_spec));
         free(data);
     }
 }
@@ -412,6 +464,7 @@ MVMObject * MVM_file_open_fh(MVMThreadContext *tc, MVMString *filename, MVMStrin
     data->fd          = fd;
     data->filename    = fname;
     data->encoding    = MVM_encoding_type_utf8;
+    MVM_string_decodestream_sep_default(tc, &(data->sep_spec));
     result->body.ops  = &op_table;
     result->body.data = data;
 
@@ -424,6 +477,7 @@ MVMObject * MVM_file_handle_from_fd(MVMThreadContext *tc, uv_file fd) {
     MVMIOFileData * const data   = calloc(1, sizeof(MVMIOFileData));
     data->fd          = fd;
     data->encoding    = MVM_encoding_type_utf8;
+    MVM_string_decodestream_sep_default(tc, &(data->sep_spec));
     result->body.ops  = &op_table;
     result->body.data = data;
     return (MVMObject *)result;
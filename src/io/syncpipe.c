@@ -46,6 +46,7 @@ static void closefh(MVMThreadContext *tc, MVMOSHandle *h) {
 static void gc_free(MVMThreadContext *tc, MVMObject *h, void *d) {
     MVMIOSyncPipeData *data = (MVMIOSyncPipeData *)d;
      do_close(tc, data);
+     MVM_string_decodestream_sep_destroy(tc, &(data->ss.sep_spec));
 }
 
 /* IO ops table, populated with functions. */
@@ -85,7 +86,7 @@ MVMObject * MVM_io_syncpipe(MVMThreadContext *tc, uv_stream_t *handle, uv_proces
     data->process     = process;
     data->ss.handle   = handle;
     data->ss.encoding = MVM_encoding_type_utf8;
-    data->ss.sep      = '\n';
+    MVM_string_decodestream_sep_default(tc, &(data->ss.sep_spec));
     result->body.ops  = &op_table;
     result->body.data = data;
     return (MVMObject *)result;
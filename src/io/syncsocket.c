@@ -33,6 +33,7 @@ static void close_socket(MVMThreadContext *tc, MVMOSHandle *h) {
 static void gc_free(MVMThreadContext *tc, MVMObject *h, void *d) {
     MVMIOSyncSocketData *data = (MVMIOSyncSocketData *)d;
     do_close(tc, data);
+    MVM_string_decodestream_sep_destroy(tc, &(data->ss.sep_spec));
 }
 
 /* Actually, it may return sockaddr_in6 as well; it's not a problem for us, because we just
@@ -197,7 +198,7 @@ static MVMObject * socket_accept(MVMThreadContext *tc, MVMOSHandle *h) {
             MVMIOSyncSocketData * const data   = calloc(1, sizeof(MVMIOSyncSocketData));
             data->ss.handle   = (uv_stream_t *)client;
             data->ss.encoding = MVM_encoding_type_utf8;
-            data->ss.sep      = '\n';
+            MVM_string_decodestream_sep_default(tc, &(data->ss.sep_spec));
             result->body.ops  = &op_table;
             result->body.data = data;
             return (MVMObject *)result;
@@ -215,7 +216,7 @@ MVMObject * MVM_io_socket_create(MVMThreadContext *tc, MVMint64 listen) {
     MVMIOSyncSocketData * const data   = calloc(1, sizeof(MVMIOSyncSocketData));
     data->ss.handle   = NULL;
     data->ss.encoding = MVM_encoding_type_utf8;
-    data->ss.sep      = '\n';
+    MVM_string_decodestream_sep_default(tc, &(data->ss.sep_spec));
     result->body.ops  = &op_table;
     result->body.data = data;
     return (MVMObject *)result;
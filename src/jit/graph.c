@@ -229,6 +229,12 @@ static void * op_to_func(MVMThreadContext *tc, MVMint16 opcode) {
     case MVM_OP_deletekey: return &MVM_repr_delete_key;
     case MVM_OP_setelemspos: return &MVM_repr_pos_set_elems;
     case MVM_OP_splice: return &MVM_repr_pos_splice;
+    case MVM_OP_arrcopy: return &MVM_array_copy;
+    case MVM_OP_arrappend: return &MVM_array_append;
+    case MVM_OP_arrfill_i: return &MVM_array_fill_i;
+    case MVM_OP_arrfill_n: return &MVM_array_fill_n;
+    case MVM_OP_arrcmp: return &MVM_array_compare;
+    case MVM_OP_arrindex_i: return &MVM_array_index_i;
     case MVM_OP_atpos_o: return &MVM_repr_at_pos_o;
     case MVM_OP_atpos_i: return &MVM_repr_at_pos_i;
     case MVM_OP_existspos: return &MVM_repr_exists_pos;
@@ -664,6 +670,14 @@ static MVMint32 jgb_consume_ins(MVMThreadContext *tc, JitGraphBuilder *jgb,
     case MVM_OP_sp_p6obind_s:
     case MVM_OP_sp_p6obind_n:
     case MVM_OP_sp_p6obind_i:
+    case MVM_OP_sp_p6oget_i32:
+    case MVM_OP_sp_p6oget_i16:
+    case MVM_OP_sp_p6oget_i8:
+    case MVM_OP_sp_p6oget_n32:
+    case MVM_OP_sp_p6obind_i32:
+    case MVM_OP_sp_p6obind_i16:
+    case MVM_OP_sp_p6obind_i8:
+    case MVM_OP_sp_p6obind_n32:
     case MVM_OP_set:
     case MVM_OP_getlex:
     case MVM_OP_getlex_no:
@@ -983,6 +997,66 @@ static MVMint32 jgb_consume_ins(MVMThreadContext *tc, JitGraphBuilder *jgb,
         jgb_append_call_c(tc, jgb, op_to_func(tc, op), 5, args, MVM_JIT_RV_VOID, -1);
         break;
     }
+    case MVM_OP_arrcopy: {
+        MVMint16 dest     = ins->operands[0].reg.orig;
+        MVMint16 dest_pos = ins->operands[1].reg.orig;
+        MVMint16 src      = ins->operands[2].reg.orig;
+        MVMint16 src_pos  = ins->operands[3].reg.orig;
+        MVMint16 count    = ins->operands[4].reg.orig;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, MVM_JIT_INTERP_TC },
+                                 { MVM_JIT_REG_VAL, dest },
+                                 { MVM_JIT_REG_VAL, dest_pos },
+                                 { MVM_JIT_REG_VAL, src },
+                                 { MVM_JIT_REG_VAL, src_pos },
+                                 { MVM_JIT_REG_VAL, count } };
+        jgb_append_call_c(tc, jgb, op_to_func(tc, op), 6, args, MVM_JIT_RV_VOID, -1);
+        break;
+    }
+    case MVM_OP_arrappend: {
+        MVMint16 dest = ins->operands[0].reg.orig;
+        MVMint16 src  = ins->operands[1].reg.orig;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, MVM_JIT_INTERP_TC },
+                                 { MVM_JIT_REG_VAL, dest },
+                                 { MVM_JIT_REG_VAL, src } };
+        jgb_append_call_c(tc, jgb, op_to_func(tc, op), 3, args, MVM_JIT_RV_VOID, -1);
+        break;
+    }
+    case MVM_OP_arrfill_i:
+    case MVM_OP_arrfill_n: {
+        MVMint16 invocant = ins->operands[0].reg.orig;
+        MVMint16 value    = ins->operands[1].reg.orig;
+        MVMint16 start    = ins->operands[2].reg.orig;
+        MVMint16 count    = ins->operands[3].reg.orig;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, MVM_JIT_INTERP_TC },
+                                 { MVM_JIT_REG_VAL, invocant },
+                                 { op == MVM_OP_arrfill_n ? MVM_JIT_REG_VAL_F : MVM_JIT_REG_VAL, value },
+                                 { MVM_JIT_REG_VAL, start },
+                                 { MVM_JIT_REG_VAL, count } };
+        jgb_append_call_c(tc, jgb, op_to_func(tc, op), 5, args, MVM_JIT_RV_VOID, -1);
+        break;
+    }
+    case MVM_OP_arrcmp: {
+        MVMint16 dst = ins->operands[0].reg.orig;
+        MVMint16 a   = ins->operands[1].reg.orig;
+        MVMint16 b   = ins->operands[2].reg.orig;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, MVM_JIT_INTERP_TC },
+                                 { MVM_JIT_REG_VAL, a },
+                                 { MVM_JIT_REG_VAL, b } };
+        jgb_append_call_c(tc, jgb, op_to_func(tc, op), 3, args, MVM_JIT_RV_INT, dst);
+        break;
+    }
+    case MVM_OP_arrindex_i: {
+        MVMint16 dst      = ins->operands[0].reg.orig;
+        MVMint16 invocant = ins->operands[1].reg.orig;
+        MVMint16 value    = ins->operands[2].reg.orig;
+        MVMint16 start    = ins->operands[3].reg.orig;
+        MVMJitCallArg args[] = { { MVM_JIT_INTERP_VAR, MVM_JIT_INTERP_TC },
+                                 { MVM_JIT_REG_VAL, invocant },
+                                 { MVM_JIT_REG_VAL, value },
+                                 { MVM_JIT_REG_VAL, start } };
+        jgb_append_call_c(tc, jgb, op_to_func(tc, op), 4, args, MVM_JIT_RV_INT, dst);
+        break;
+    }
     case MVM_OP_atpos_o: {
         MVMint16 dst = ins->operands[0].reg.orig;
         MVMint32 invocant = ins->operands[1].reg.orig;
@@ -8,6 +8,22 @@
 	} \
 } while (0)
 
+/* Reads a positive integer setting from an environment variable, clamped to
+ * the given bounds. Returns zero, leaving the value alone, if the variable
+ * is unset or isn't a positive decimal number. */
+static int env_positive_int(const char *name, MVMuint64 min, MVMuint64 max, MVMuint64 *value) {
+    char               *str = getenv(name);
+    char               *end;
+    unsigned long long  parsed;
+    if (!str || *str < '0' || *str > '9')
+        return 0;
+    parsed = strtoull(str, &end, 10);
+    if (*end || parsed == 0)
+        return 0;
+    *value = parsed < min ? min : parsed > max ? max : parsed;
+    return 1;
+}
+
 /* Create a new instance of the VM. */
 static void string_consts(MVMThreadContext *tc);
 static void setup_std_handles(MVMThreadContext *tc);
@@ -16,11 +32,48 @@ MVMInstance * MVM_vm_create_instance(void) {
     char *spesh_log, *spesh_disable, *spesh_inline_disable, *spesh_osr_disable;
     char *jit_log, *jit_disable, *jit_bytecode_dir;
     char *dynvar_log;
-    int init_stat;
+    char *gc_stats_log;
+    MVMuint64 nursery_min = MVM_NURSERY_MIN_SIZE, nursery_max = MVM_NURSERY_MAX_SIZE;
+    MVMuint64 gen2_growth = MVM_GC_GEN2_GROWTH;
+    int init_stat, have_min, have_max;
 
     /* Set up instance data structure. */
     instance = calloc(1, sizeof(MVMInstance));
 
+    /* Work out the bounds for adaptive nursery sizing; these must be known
+     * before we create any thread context. Settings that aren't sizes are
+     * ignored. If only one bound is set, and it's on the wrong side of the
+     * other's default, that default moves to match; if both are set but
+     * the wrong way around, neither is used. */
+    have_min = env_positive_int("MVM_NURSERY_MIN_SIZE",
+        MVM_NURSERY_SIZE_FLOOR, MVM_NURSERY_SIZE_CEILING, &nursery_min);
+    have_max = env_positive_int("MVM_NURSERY_MAX_SIZE",
+        MVM_NURSERY_SIZE_FLOOR, MVM_NURSERY_SIZE_CEILING, &nursery_max);
+    if (nursery_min > nursery_max) {
+        if (have_min && have_max) {
+            nursery_min = MVM_NURSERY_MIN_SIZE;
+            nursery_max = MVM_NURSERY_MAX_SIZE;
+        }
+        else if (have_min) {
+            nursery_max = nursery_min;
+        }
+        else {
+            nursery_min = nursery_max;
+        }
+    }
+    instance->nursery_size_min = (MVMuint32)nursery_min;
+    instance->nursery_size_max = (MVMuint32)nursery_max;
+
+    /* Work out how much gen2 should grow before a full collection. */
+    env_positive_int("MVM_GC_GEN2_GROWTH", 1, MVM_GC_GEN2_MAX_GROWTH, &gen2_growth);
+    instance->gc_gen2_growth = (MVMuint32)gen2_growth;
+
+    /* Check if we've a file we should log GC run statistics to. */
+    gc_stats_log = getenv("MVM_GC_STATS_LOG");
+    if (gc_stats_log && strlen(gc_stats_log))
+        instance->gc_stats_fh = fopen(gc_stats_log, "w");
+    init_mutex(instance->mutex_gc_stats_log, "GC stats log");
+
     /* Create the main thread's ThreadContext and stash it. */
     instance->main_thread = MVM_tc_create(instance);
     instance->main_thread->thread_id = 1;
@@ -57,6 +110,9 @@ MVMInstance * MVM_vm_create_instance(void) {
     /* Set up weak reference hash mutex. */
     init_mutex(instance->mutex_sc_weakhash, "sc weakhash");
 
+    /* Set up interned strings table mutex. */
+    init_mutex(instance->mutex_interned_strings, "interned strings");
+
     /* Set up loaded compunits hash mutex. */
     init_mutex(instance->mutex_loaded_compunits, "loaded compunits");
 
@@ -224,6 +280,8 @@ void MVM_vm_exit(MVMInstance *instance) {
         fclose(instance->spesh_log_fh);
     if (instance->jit_log_fh)
         fclose(instance->jit_log_fh);
+    if (instance->gc_stats_fh)
+        fclose(instance->gc_stats_fh);
 
     /* And, we're done. */
     exit(0);
@@ -270,6 +328,9 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
     uv_mutex_destroy(&instance->mutex_sc_weakhash);
     MVM_HASH_DESTROY(hash_handle, MVMSerializationContextBody, instance->sc_weakhash);
 
+    /* Clean up table of interned strings. */
+    MVM_string_intern_destroy(instance->main_thread);
+
     /* Clean up Hash of filenames of compunits loaded from disk. */
     uv_mutex_destroy(&instance->mutex_loaded_compunits);
     MVM_HASH_DESTROY(hash_handle, MVMLoadedCompUnitName, instance->loaded_compunits);
@@ -290,6 +351,12 @@ void MVM_vm_destroy_instance(MVMInstance *instance) {
         fclose(instance->spesh_log_fh);
     if (instance->jit_log_fh)
         fclose(instance->jit_log_fh);
+    if (instance->gc_stats_fh)
+        fclose(instance->gc_stats_fh);
+
+    /* Clean up GC statistics. */
+    uv_mutex_destroy(&instance->mutex_gc_stats_log);
+    MVM_checked_free_null(instance->gc_stats_heap);
 
     /* Clean up event loop starting mutex. */
     uv_mutex_destroy(&instance->mutex_event_loop_start);
@@ -128,6 +128,7 @@ typedef double   MVMnum64;
 #include "gc/orchestrate.h"
 #include "gc/gen2.h"
 #include "gc/roots.h"
+#include "gc/stats.h"
 #include "spesh/dump.h"
 #include "spesh/graph.h"
 #include "spesh/codegen.h"
@@ -147,6 +148,7 @@ typedef double   MVMnum64;
 #include "strings/utf16.h"
 #include "strings/iter.h"
 #include "strings/ops.h"
+#include "strings/intern.h"
 #include "strings/unicode_gen.h"
 #include "strings/unicode.h"
 #include "strings/latin1.h"
@@ -189,6 +191,14 @@ MVM_PUBLIC void MVM_vm_destroy_instance(MVMInstance *instance);
 /* Returns non-zero for success. Use for both AO_t numbers and pointers. */
 #define MVM_trycas(addr, old, new) AO_compare_and_swap_full((volatile AO_t *)(addr), (AO_t)(old), (AO_t)(new))
 
+/* Returns non-zero for success. For 16-bit values, such as collectable
+ * flags, which libatomic_ops has no portable compare and swap for. */
+#ifdef _MSC_VER
+#define MVM_trycas16(addr, old, new) (_InterlockedCompareExchange16((volatile short *)(addr), (short)(new), (short)(old)) == (short)(old))
+#else
+#define MVM_trycas16(addr, old, new) __sync_bool_compare_and_swap((volatile MVMuint16 *)(addr), (MVMuint16)(old), (MVMuint16)(new))
+#endif
+
 /* Returns the old value dereferenced at addr. */
 #define MVM_cas(addr, old, new) AO_fetch_compare_and_swap_full((addr), (old), (new))
 
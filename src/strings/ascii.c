@@ -32,7 +32,7 @@ MVMString * MVM_string_ascii_decode_nt(MVMThreadContext *tc, MVMObject *result_t
 /* Decodes using a decodestream. Decodes as far as it can with the input
  * buffers, or until a stopper is reached. */
 void MVM_string_ascii_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
-                                   MVMint32 *stopper_chars, MVMint32 *stopper_sep) {
+                                   MVMint32 *stopper_chars, const MVMDecodeStreamSeparators *stopper_sep) {
     MVMint32              count = 0, total = 0;
     MVMint32              bufsize;
     MVMGrapheme32        *buffer;
@@ -77,7 +77,7 @@ void MVM_string_ascii_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
             total++;
             if (stopper_chars && *stopper_chars == total)
                 goto done;
-            if (stopper_sep && *stopper_sep == codepoint)
+            if (stopper_sep && MVM_string_decodestream_maybe_sep(stopper_sep, codepoint))
                 goto done;
         }
         cur_bytes = cur_bytes->next;
@@ -91,44 +91,25 @@ void MVM_string_ascii_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
     MVM_string_decodestream_discard_to(tc, ds, last_accept_bytes, last_accept_pos);
 }
 
+/* Encodes the specified substring to ASCII into the supplied buffer, which
+ * must have room for one byte per grapheme. Returns the number of bytes
+ * written. */
+MVMuint64 MVM_string_ascii_encode_into(MVMThreadContext *tc, MVMString *str,
+        MVMint64 start, MVMint64 length, MVMuint8 *buffer) {
+    MVMuint32 lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    MVM_string_encode_range_bytes(tc, str, (MVMuint32)start, lengthu, buffer, 127);
+    return lengthu;
+}
+
 /* Encodes the specified substring to ASCII. Anything outside of ASCII range
  * will become a ?. The result string is NULL terminated, but the specified
  * size is the non-null part. */
 MVMuint8 * MVM_string_ascii_encode_substr(MVMThreadContext *tc, MVMString *str, MVMuint64 *output_size, MVMint64 start, MVMint64 length) {
-    /* ASCII is a single byte encoding, so each grapheme will just become
-     * a single byte. */
-    MVMuint32      startu    = (MVMuint32)start;
-    MVMStringIndex strgraphs = MVM_string_graphs(tc, str);
-    MVMuint32      lengthu   = (MVMuint32)(length == -1 ? strgraphs - startu : length);
-    MVMuint8      *result;
-    size_t         i;
-
-    /* must check start first since it's used in the length check */
-    if (start < 0 || start > strgraphs)
-        MVM_exception_throw_adhoc(tc, "start out of range");
-    if (length < -1 || start + lengthu > strgraphs)
-        MVM_exception_throw_adhoc(tc, "length out of range");
-
-    result = malloc(lengthu + 1);
-    if (str->body.storage_type == MVM_STRING_GRAPHEME_ASCII) {
-        /* No encoding needed; directly copy. */
-        memcpy(result, str->body.storage.blob_ascii, lengthu);
-        result[lengthu] = 0;
-    }
-    else {
-        MVMuint32 i = 0;
-        MVMCodepointIter ci;
-        MVM_string_ci_init(tc, &ci, str);
-        while (MVM_string_ci_has_more(tc, &ci)) {
-            MVMCodepoint ord = MVM_string_ci_get_codepoint(tc, &ci);
-            if (ord >= 0 && ord <= 127)
-                result[i] = (MVMuint8)ord;
-            else
-                result[i] = '?';
-            i++;
-        }
-        result[i] = 0;
-    }
+    MVMuint32  lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    MVMuint8  *result  = malloc(lengthu + 1);
+
+    MVM_string_encode_range_bytes(tc, str, (MVMuint32)start, lengthu, result, 127);
+    result[lengthu] = 0;
 
     if (output_size)
         *output_size = lengthu;
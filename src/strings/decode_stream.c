@@ -72,7 +72,7 @@ void MVM_string_decodestream_discard_to(MVMThreadContext *tc, MVMDecodeStream *d
 }
 
 /* Does a decode run, selected by encoding. */
-static run_decode(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 *stopper_chars, MVMint32 *stopper_sep) {
+static void run_decode(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 *stopper_chars, const MVMDecodeStreamSeparators *stopper_sep) {
     switch (ds->encoding) {
     case MVM_encoding_type_utf8:
         MVM_string_utf8_decodestream(tc, ds, stopper_chars, stopper_sep);
@@ -104,11 +104,9 @@ static MVMint32 missing_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint3
     return got >= wanted ? 0 : wanted - got;
 }
 static MVMString * take_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 chars) {
-    MVMint32   found             = 0;
-    MVMString *result            = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    result->body.storage.blob_32 = malloc(chars * sizeof(MVMGrapheme32));
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.num_graphs      = chars;
+    MVMint32       found  = 0;
+    MVMString     *result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
+    MVMGrapheme32 *buffer = malloc(chars * sizeof(MVMGrapheme32));
     while (found < chars) {
         MVMDecodeStreamChars *cur_chars = ds->chars_head;
         MVMint32 available = cur_chars->length - ds->chars_head_pos;
@@ -116,7 +114,7 @@ static MVMString * take_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint3
             /* We need all that's left in this buffer and likely
              * more. */
             MVMDecodeStreamChars *next_chars = cur_chars->next;
-            memcpy(result->body.storage.blob_32 + found, cur_chars->chars + ds->chars_head_pos,
+            memcpy(buffer + found, cur_chars->chars + ds->chars_head_pos,
                 available * sizeof(MVMGrapheme32));
             found += available;
             free(cur_chars->chars);
@@ -131,12 +129,13 @@ static MVMString * take_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint3
             /* There's enough in this buffer to satisfy us, and we'll leave
              * some behind. */
             MVMint32 take = chars - found;
-            memcpy(result->body.storage.blob_32 + found, cur_chars->chars + ds->chars_head_pos,
+            memcpy(buffer + found, cur_chars->chars + ds->chars_head_pos,
                 take * sizeof(MVMGrapheme32));
             found += take;
             ds->chars_head_pos += take;
         }
     }
+    MVM_string_set_blob_32(tc, result, buffer, chars);
     return result;
 }
 MVMString * MVM_string_decodestream_get_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 chars) {
@@ -158,33 +157,83 @@ MVMString * MVM_string_decodestream_get_chars(MVMThreadContext *tc, MVMDecodeStr
         return NULL;
 }
 
-/* Gets characters up until the specified string is encountered. If we do
- * not encounter it, returns NULL. This may mean more input buffers are needed
- * or that we reached the end of the stream. */
-MVMint32 find_separator(MVMThreadContext *tc, MVMDecodeStream *ds, MVMGrapheme32 sep) {
+/* Checks if a separator's graphemes appear starting at the given position
+ * in a char buffer, following the linked list of buffers as needed. */
+static MVMint32 sep_matches_at(MVMDecodeStreamChars *cur_chars, MVMint32 pos,
+        const MVMGrapheme32 *sep, MVMint32 length) {
+    MVMint32 i;
+    for (i = 0; i < length; i++) {
+        while (pos == cur_chars->length) {
+            cur_chars = cur_chars->next;
+            if (!cur_chars)
+                return 0;
+            pos = 0;
+        }
+        if (cur_chars->chars[pos++] != sep[i])
+            return 0;
+    }
+    return 1;
+}
+
+/* Looks for the first place any of the separators appears, starting from the
+ * char offset given, and returns the number of chars up to and including it;
+ * where two separators start at the same place, the first listed wins. If
+ * none is found, returns 0 and sets available to the number of chars that
+ * are available. */
+static MVMint32 find_separator(MVMThreadContext *tc, MVMDecodeStream *ds,
+        const MVMDecodeStreamSeparators *sep_spec, MVMint32 from, MVMint32 *available) {
     MVMint32 sep_loc = 0;
     MVMDecodeStreamChars *cur_chars = ds->chars_head;
     while (cur_chars) {
         MVMint32 start = cur_chars == ds->chars_head ? ds->chars_head_pos : 0;
-        MVMint32 i = 0;
+        MVMint32 i;
+        if (sep_loc + cur_chars->length - start <= from) {
+            sep_loc  += cur_chars->length - start;
+            cur_chars = cur_chars->next;
+            continue;
+        }
+        if (sep_loc < from) {
+            start  += from - sep_loc;
+            sep_loc = from;
+        }
         for (i = start; i < cur_chars->length; i++) {
+            const MVMGrapheme32 *sep = sep_spec->sep_graphemes;
+            MVMint32 s;
+            for (s = 0; s < sep_spec->num_seps; s++) {
+                MVMint32 length = sep_spec->sep_lengths[s];
+                if (cur_chars->chars[i] == sep[0] && sep_matches_at(cur_chars, i, sep, length))
+                    return sep_loc + length;
+                sep += length;
+            }
             sep_loc++;
-            if (cur_chars->chars[i] == sep)
-                return sep_loc;
         }
         cur_chars = cur_chars->next;
     }
+    *available = sep_loc;
     return 0;
 }
-MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecodeStream *ds, MVMGrapheme32 sep) {
-    MVMint32 sep_loc;
-
-    /* Look for separator, trying more decoding if it fails. We get the place
-     * just beyond the separator, so can use take_chars to get what's need. */
-    sep_loc = find_separator(tc, ds, sep);
-    if (!sep_loc) {
-        run_decode(tc, ds, NULL, &sep);
-        sep_loc = find_separator(tc, ds, sep);
+
+/* Gets characters up until and including the first of the separators that
+ * is encountered. If we do not encounter one, returns NULL. This may mean
+ * more input buffers are needed or that we reached the end of the stream. */
+MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecodeStream *ds,
+        const MVMDecodeStreamSeparators *sep_spec) {
+    MVMint32 sep_loc, available;
+
+    /* Look for separator, trying more decoding if it fails. Decoding stops
+     * at anything that may end a separator, so we may need to go around a
+     * few times. Each time, only the chars that could be the start of a
+     * separator ending in the newly decoded ones are searched again. We get
+     * the place just beyond the separator, so can use take_chars to get
+     * what's needed. */
+    sep_loc = find_separator(tc, ds, sep_spec, 0, &available);
+    while (!sep_loc) {
+        MVMint32 had = available;
+        MVMint32 from = had - (sep_spec->max_sep_length - 1);
+        run_decode(tc, ds, NULL, sep_spec);
+        sep_loc = find_separator(tc, ds, sep_spec, from > 0 ? from : 0, &available);
+        if (!sep_loc && available == had)
+            break;
     }
     if (sep_loc)
         return take_chars(tc, ds, sep_loc);
@@ -195,24 +244,25 @@ MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecod
 /* Decodes all the buffers, producing a string containing all the decoded
  * characters. */
 MVMString * MVM_string_decodestream_get_all(MVMThreadContext *tc, MVMDecodeStream *ds) {
-    MVMString *result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    result->body.storage_type = MVM_STRING_GRAPHEME_32;
+    MVMString     *result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
+    MVMGrapheme32 *buffer;
+    MVMint32       length;
 
     /* Decode all the things. */
     run_decode(tc, ds, NULL, NULL);
 
     /* If there's no codepoint buffer, then return the empty string. */
     if (!ds->chars_head) {
-        result->body.storage.blob_32 = NULL;
-        result->body.num_graphs      = 0;
+        buffer = NULL;
+        length = 0;
     }
-    
+
     /* If there's exactly one resulting codepoint buffer and we swallowed none
      * of it, just use it. */
     else if (ds->chars_head == ds->chars_tail && ds->chars_head_pos == 0) {
         /* Set up result string. */
-        result->body.storage.blob_32 = ds->chars_head->chars;
-        result->body.num_graphs      = ds->chars_head->length;
+        buffer = ds->chars_head->chars;
+        length = ds->chars_head->length;
 
         /* Don't free the buffer's memory itself, just the holder, as we
          * stole that for the buffer into the string above. */
@@ -223,8 +273,9 @@ MVMString * MVM_string_decodestream_get_all(MVMThreadContext *tc, MVMDecodeStrea
     /* Otherwise, need to assemble all the things. */
     else {
         /* Calculate length. */
-        MVMint32 length = 0, pos = 0;
+        MVMint32 pos = 0;
         MVMDecodeStreamChars *cur_chars = ds->chars_head;
+        length = 0;
         while (cur_chars) {
             if (cur_chars == ds->chars_head)
                 length += cur_chars->length - ds->chars_head_pos;
@@ -234,28 +285,32 @@ MVMString * MVM_string_decodestream_get_all(MVMThreadContext *tc, MVMDecodeStrea
         }
 
         /* Allocate a result buffer of the right size. */
-        result->body.storage.blob_32 = malloc(length * sizeof(MVMGrapheme32));
-        result->body.num_graphs      = length;
+        buffer = malloc(length * sizeof(MVMGrapheme32));
 
         /* Copy all the things into the target, freeing as we go. */
         cur_chars = ds->chars_head;
         while (cur_chars) {
+            MVMDecodeStreamChars *next_chars = cur_chars->next;
             if (cur_chars == ds->chars_head) {
                 MVMint32 to_copy = ds->chars_head->length - ds->chars_head_pos;
-                memcpy(result->body.storage.blob_32 + pos, cur_chars->chars + ds->chars_head_pos,
-                    cur_chars->length * sizeof(MVMGrapheme32));
+                memcpy(buffer + pos, cur_chars->chars + ds->chars_head_pos,
+                    to_copy * sizeof(MVMGrapheme32));
                 pos += to_copy;
             }
             else {
-                memcpy(result->body.storage.blob_32 + pos, cur_chars->chars,
+                memcpy(buffer + pos, cur_chars->chars,
                     cur_chars->length * sizeof(MVMGrapheme32));
                 pos += cur_chars->length;
             }
-            cur_chars = cur_chars->next;
+            free(cur_chars->chars);
+            free(cur_chars);
+            cur_chars = next_chars;
         }
         ds->chars_head = ds->chars_tail = NULL;
+        ds->chars_head_pos = 0;
     }
 
+    MVM_string_set_blob_32(tc, result, buffer, length);
     return result;
 }
 
@@ -334,3 +389,58 @@ void MVM_string_decodestream_destory(MVMThreadContext *tc, MVMDecodeStream *ds)
     }
     free(ds);
 }
+
+/* Sets up the default separators: just a newline. */
+void MVM_string_decodestream_sep_default(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec) {
+    MVM_string_decodestream_sep_destroy(tc, sep_spec);
+    sep_spec->num_seps           = 1;
+    sep_spec->max_sep_length     = 1;
+    sep_spec->sep_lengths        = malloc(sizeof(MVMint32));
+    sep_spec->sep_graphemes      = malloc(sizeof(MVMGrapheme32));
+    sep_spec->final_graphemes    = malloc(sizeof(MVMGrapheme32));
+    sep_spec->sep_lengths[0]     = 1;
+    sep_spec->sep_graphemes[0]   = '\n';
+    sep_spec->final_graphemes[0] = '\n';
+}
+
+/* Sets the separators to the given strings, replacing any existing ones. */
+void MVM_string_decodestream_sep_from_strings(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec,
+        MVMString **seps, MVMint32 num_seps) {
+    MVMint32 i, total = 0, max = 0, pos = 0;
+
+    if (num_seps < 1)
+        MVM_exception_throw_adhoc(tc, "Must provide at least one separator");
+    for (i = 0; i < num_seps; i++) {
+        MVMint32 length = MVM_string_graphs(tc, seps[i]);
+        if (length == 0)
+            MVM_exception_throw_adhoc(tc, "Cannot use an empty string as a separator");
+        total += length;
+        if (length > max)
+            max = length;
+    }
+
+    MVM_string_decodestream_sep_destroy(tc, sep_spec);
+    sep_spec->num_seps        = num_seps;
+    sep_spec->max_sep_length  = max;
+    sep_spec->sep_lengths     = malloc(num_seps * sizeof(MVMint32));
+    sep_spec->sep_graphemes   = malloc(total * sizeof(MVMGrapheme32));
+    sep_spec->final_graphemes = malloc(num_seps * sizeof(MVMGrapheme32));
+    for (i = 0; i < num_seps; i++) {
+        MVMint32 length = MVM_string_graphs(tc, seps[i]);
+        MVMint32 j;
+        for (j = 0; j < length; j++)
+            sep_spec->sep_graphemes[pos + j] = MVM_string_get_grapheme_at_nocheck(tc, seps[i], j);
+        sep_spec->sep_lengths[i]     = length;
+        sep_spec->final_graphemes[i] = sep_spec->sep_graphemes[pos + length - 1];
+        pos += length;
+    }
+}
+
+/* Frees the memory held by a set of separators. */
+void MVM_string_decodestream_sep_destroy(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec) {
+    MVM_checked_free_null(sep_spec->sep_lengths);
+    MVM_checked_free_null(sep_spec->sep_graphemes);
+    MVM_checked_free_null(sep_spec->final_graphemes);
+    sep_spec->num_seps       = 0;
+    sep_spec->max_sep_length = 0;
+}
@@ -36,15 +36,43 @@ struct MVMDecodeStreamChars {
     MVMDecodeStreamChars *next;
 };
 
+/* A set of separators to read records up until; a record ends wherever any
+ * of them is first found. Separators may be more than one grapheme long. */
+struct MVMDecodeStreamSeparators {
+    /* The graphemes of all of the separators, one after another. */
+    MVMGrapheme32 *sep_graphemes;
+
+    /* The length of each separator, and the last grapheme of each. */
+    MVMint32      *sep_lengths;
+    MVMGrapheme32 *final_graphemes;
+
+    /* The number of separators, and the length of the longest one. */
+    MVMint32 num_seps;
+    MVMint32 max_sep_length;
+};
+
 MVMDecodeStream * MVM_string_decodestream_create(MVMThreadContext *tc, MVMint32 encoding, MVMint64 abs_byte_pos);
 void MVM_string_decodestream_add_bytes(MVMThreadContext *tc, MVMDecodeStream *ds, char *bytes, MVMint32 length);
 void MVM_string_decodestream_add_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMGrapheme32 *chars, MVMint32 length);
 void MVM_string_decodestream_discard_to(MVMThreadContext *tc, MVMDecodeStream *ds, MVMDecodeStreamBytes *bytes, MVMint32 pos);
 MVMString * MVM_string_decodestream_get_chars(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 chars);
-MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecodeStream *ds, MVMGrapheme32 sep);
+MVMString * MVM_string_decodestream_get_until_sep(MVMThreadContext *tc, MVMDecodeStream *ds, const MVMDecodeStreamSeparators *sep_spec);
 MVMString * MVM_string_decodestream_get_all(MVMThreadContext *tc, MVMDecodeStream *ds);
 MVMint64 MVM_string_decodestream_have_bytes(MVMThreadContext *tc, MVMDecodeStream *ds, MVMint32 bytes);
 MVMint64 MVM_string_decodestream_bytes_to_buf(MVMThreadContext *tc, MVMDecodeStream *ds, char **buf, MVMint32 bytes);
 MVMint64 MVM_string_decodestream_tell_bytes(MVMThreadContext *tc, MVMDecodeStream *ds);
 MVMint32 MVM_string_decodestream_is_empty(MVMThreadContext *tc, MVMDecodeStream *ds);
 void MVM_string_decodestream_destory(MVMThreadContext *tc, MVMDecodeStream *ds);
+void MVM_string_decodestream_sep_default(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec);
+void MVM_string_decodestream_sep_from_strings(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec, MVMString **seps, MVMint32 num_seps);
+void MVM_string_decodestream_sep_destroy(MVMThreadContext *tc, MVMDecodeStreamSeparators *sep_spec);
+
+/* Checks if a grapheme is the last one of any of the separators; decoders
+ * stop there, so the stream can be checked for a complete separator. */
+MVM_STATIC_INLINE MVMint32 MVM_string_decodestream_maybe_sep(const MVMDecodeStreamSeparators *sep_spec, MVMGrapheme32 g) {
+    MVMint32 i;
+    for (i = 0; i < sep_spec->num_seps; i++)
+        if (sep_spec->final_graphemes[i] == g)
+            return 1;
+    return 0;
+}
@@ -0,0 +1,101 @@
+#include "moar.h"
+
+/* Notes an entry whose string is in a nursery. */
+static void add_nursery_entry(MVMInstance *instance, MVMInternedString *entry) {
+    if (instance->num_interned_nursery == instance->alloc_interned_nursery) {
+        instance->alloc_interned_nursery = instance->alloc_interned_nursery
+            ? instance->alloc_interned_nursery * 2
+            : 64;
+        instance->interned_nursery = realloc(instance->interned_nursery,
+            sizeof(MVMInternedString *) * instance->alloc_interned_nursery);
+    }
+    instance->interned_nursery[instance->num_interned_nursery++] = entry;
+}
+
+/* Gets the canonical copy of a string: the one already in the intern table
+ * if there is one with the same graphemes, or otherwise the string itself,
+ * which is then added to the table. Interned strings are flagged as such, so
+ * that comparing two of them needs only a pointer comparison, and have their
+ * hash code computed up front. */
+MVMString * MVM_string_intern(MVMThreadContext *tc, MVMString *s) {
+    MVMInstance       *instance = tc->instance;
+    MVMInternedString *entry;
+
+    if (!s || s->body.interned)
+        return s;
+
+    /* Compute the hash code before taking the lock; nothing in here may
+     * allocate, as a GC run cannot start while we hold it. */
+    MVM_string_hash_code(tc, s);
+    uv_mutex_lock(&instance->mutex_interned_strings);
+    MVM_HASH_GET(tc, instance->interned_strings, s, entry);
+    if (entry) {
+        s = entry->str;
+    }
+    else {
+        entry = malloc(sizeof(MVMInternedString));
+        entry->str = s;
+        MVM_HASH_BIND(tc, instance->interned_strings, s, entry, str);
+        s->body.interned = 1;
+        if (!(s->common.header.flags & MVM_CF_SECOND_GEN))
+            add_nursery_entry(instance, entry);
+    }
+    uv_mutex_unlock(&instance->mutex_interned_strings);
+
+    return s;
+}
+
+/* Called by the GC co-ordinator once marking is complete, with the world
+ * still stopped. Drops entries for strings that were not marked, and points
+ * those for strings that moved out of the nursery at their new location. In
+ * a nursery-only run, anything already in gen2 is alive, so only the entries
+ * whose string was in the nursery need looking at. */
+void MVM_string_intern_sweep(MVMThreadContext *tc, MVMuint8 gen) {
+    MVMInstance       *instance = tc->instance;
+    MVMInternedString *entry, *tmp;
+    if (gen == MVMGCGenerations_Nursery) {
+        MVMuint32 i, insert_pos = 0;
+        for (i = 0; i < instance->num_interned_nursery; i++) {
+            MVMCollectable *item;
+            entry = instance->interned_nursery[i];
+            item  = &(entry->str->common.header);
+            if (item->flags & MVM_CF_FORWARDER_VALID) {
+                entry->str = (MVMString *)item->sc_forward_u.forwarder;
+                if (!(entry->str->common.header.flags & MVM_CF_SECOND_GEN))
+                    instance->interned_nursery[insert_pos++] = entry;
+            }
+            else {
+                HASH_DELETE(hash_handle, instance->interned_strings, entry);
+                free(entry);
+            }
+        }
+        instance->num_interned_nursery = insert_pos;
+        return;
+    }
+
+    /* A full run; rebuild the list of nursery entries as we go. */
+    instance->num_interned_nursery = 0;
+    HASH_ITER(hash_handle, instance->interned_strings, entry, tmp) {
+        MVMCollectable *item = &(entry->str->common.header);
+        if (item->flags & MVM_CF_SECOND_GEN) {
+            if (item->flags & MVM_CF_GEN2_LIVE)
+                continue;
+        }
+        else if (item->flags & MVM_CF_FORWARDER_VALID) {
+            entry->str = (MVMString *)item->sc_forward_u.forwarder;
+            if (!(entry->str->common.header.flags & MVM_CF_SECOND_GEN))
+                add_nursery_entry(instance, entry);
+            continue;
+        }
+        HASH_DELETE(hash_handle, instance->interned_strings, entry);
+        free(entry);
+    }
+}
+
+/* Frees the intern table, at instance destruction. */
+void MVM_string_intern_destroy(MVMThreadContext *tc) {
+    MVMInstance *instance = tc->instance;
+    uv_mutex_destroy(&instance->mutex_interned_strings);
+    free(instance->interned_nursery);
+    MVM_HASH_DESTROY(hash_handle, MVMInternedString, instance->interned_strings);
+}
@@ -0,0 +1,14 @@
+/* An entry in the instance-wide table of interned strings. The table holds
+ * its strings weakly: entries whose string was not otherwise kept alive are
+ * dropped at the end of each GC run. */
+struct MVMInternedString {
+    /* The interned string; also the hash key. */
+    MVMString *str;
+
+    /* The uthash hash handle inline struct. */
+    UT_hash_handle hash_handle;
+};
+
+MVMString * MVM_string_intern(MVMThreadContext *tc, MVMString *s);
+void MVM_string_intern_sweep(MVMThreadContext *tc, MVMuint8 gen);
+void MVM_string_intern_destroy(MVMThreadContext *tc);
@@ -141,10 +141,52 @@ MVM_STATIC_INLINE MVMGrapheme32 MVM_string_gi_get_grapheme(MVMThreadContext *tc,
     }
 }
 
+/* Gets the next run of up to max graphemes that are stored contiguously in
+ * one blob, so bulk operations can work a strand at a time rather than a
+ * grapheme at a time. Returns the number of graphemes in the run, which is
+ * 0 only when max is 0; the blob type and a pointer to its first grapheme
+ * are written to the out parameters. */
+MVM_STATIC_INLINE MVMuint32 MVM_string_gi_next_run(MVMThreadContext *tc, MVMGraphemeIter *gi,
+        MVMuint32 max, MVMuint16 *blob_type, void **run) {
+    while (max) {
+        if (gi->pos < gi->end) {
+            MVMuint32 length = gi->end - gi->pos;
+            if (length > max)
+                length = max;
+            *blob_type = gi->blob_type;
+            *run = gi->blob_type == MVM_STRING_GRAPHEME_32
+                ? (void *)(gi->active_blob.blob_32 + gi->pos)
+                : (void *)(gi->active_blob.blob_8 + gi->pos);
+            gi->pos += length;
+            return length;
+        }
+        else if (gi->repetitions) {
+            gi->pos = gi->start;
+            gi->repetitions--;
+        }
+        else if (gi->strands_remaining) {
+            MVMStringStrand *next = gi->next_strand;
+            gi->active_blob.any = next->blob_string->body.storage.any;
+            gi->blob_type       = next->blob_string->body.storage_type;
+            gi->pos             = next->start;
+            gi->end             = next->end;
+            gi->start           = next->start;
+            gi->repetitions     = next->repetitions;
+            gi->strands_remaining--;
+            gi->next_strand++;
+        }
+        else {
+            MVM_exception_throw_adhoc(tc, "Iteration past end of grapheme iterator");
+        }
+    }
+    return 0;
+}
+
 /* For now, our strings aren't really at grapheme level, but rather at code
  * point level, so our codepoint iterator is really just the same. This will
  * need to change upon implementing NFG. */
 typedef MVMGraphemeIter MVMCodepointIter;
 #define MVM_string_ci_init(a,b,c)       MVM_string_gi_init(a,b,c)
 #define MVM_string_ci_has_more(a,b)     MVM_string_gi_has_more(a, b)
+#define MVM_string_ci_move_to(a,b,c)    MVM_string_gi_move_to(a, b, c)
 #define MVM_string_ci_get_codepoint(a,b) MVM_string_gi_get_grapheme(a, b)
@@ -6,14 +6,13 @@
 MVMString * MVM_string_latin1_decode(MVMThreadContext *tc, MVMObject *result_type,
                                      MVMuint8 *latin1, size_t bytes) {
     MVMString *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
-    size_t i;
 
-    result->body.num_graphs      = bytes;
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.storage.blob_32 = malloc(sizeof(MVMint32) * bytes);
-
-    for (i = 0; i < bytes; i++)
-        result->body.storage.blob_32[i] = latin1[i];
+    /* Every latin-1 byte is the codepoint itself, so they can be used as
+     * 8-bit storage directly. */
+    result->body.num_graphs     = bytes;
+    result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+    result->body.storage.blob_8 = malloc(bytes);
+    memcpy(result->body.storage.blob_8, latin1, bytes);
 
     return result;
 }
@@ -21,7 +20,7 @@ MVMString * MVM_string_latin1_decode(MVMThreadContext *tc, MVMObject *result_typ
 /* Decodes using a decodestream. Decodes as far as it can with the input
  * buffers, or until a stopper is reached. */
 void MVM_string_latin1_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
-                                    MVMint32 *stopper_chars, MVMint32 *stopper_sep) {
+                                    MVMint32 *stopper_chars, const MVMDecodeStreamSeparators *stopper_sep) {
     MVMint32 count = 0, total = 0;
     MVMint32 bufsize;
     MVMGrapheme32 *buffer;
@@ -63,7 +62,7 @@ void MVM_string_latin1_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
             total++;
             if (stopper_chars && *stopper_chars == total)
                 goto done;
-            if (stopper_sep && *stopper_sep == codepoint)
+            if (stopper_sep && MVM_string_decodestream_maybe_sep(stopper_sep, codepoint))
                 goto done;
         }
         cur_bytes = cur_bytes->next;
@@ -77,45 +76,28 @@ void MVM_string_latin1_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
     MVM_string_decodestream_discard_to(tc, ds, last_accept_bytes, last_accept_pos);
 }
 
+/* Encodes the specified substring to latin-1 into the supplied buffer, which
+ * must have room for one byte per grapheme. Returns the number of bytes
+ * written. */
+MVMuint64 MVM_string_latin1_encode_into(MVMThreadContext *tc, MVMString *str,
+        MVMint64 start, MVMint64 length, MVMuint8 *buffer) {
+    MVMuint32 lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    MVM_string_encode_range_bytes(tc, str, (MVMuint32)start, lengthu, buffer, 255);
+    return lengthu;
+}
+
 /* Encodes the specified substring to latin-1. Anything outside of latin-1 range
  * will become a ?. The result string is NULL terminated, but the specified
  * size is the non-null part. */
 MVMuint8 * MVM_string_latin1_encode_substr(MVMThreadContext *tc, MVMString *str, MVMuint64 *output_size, MVMint64 start, MVMint64 length) {
-    /* Latin-1 is a single byte encoding, so each grapheme will just become
-     * a single byte. */
-    MVMuint32 startu = (MVMuint32)start;
-    MVMStringIndex strgraphs = MVM_string_graphs(tc, str);
-    MVMuint32 lengthu = (MVMuint32)(length == -1 ? strgraphs - startu : length);
-    MVMuint8 *result;
-    size_t i;
+    MVMuint32  lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    MVMuint8  *result  = malloc(lengthu + 1);
 
-    /* must check start first since it's used in the length check */
-    if (start < 0 || start > strgraphs)
-        MVM_exception_throw_adhoc(tc, "start out of range");
-    if (length < -1 || start + lengthu > strgraphs)
-        MVM_exception_throw_adhoc(tc, "length out of range");
+    MVM_string_encode_range_bytes(tc, str, (MVMuint32)start, lengthu, result, 255);
+    result[lengthu] = 0;
 
-    result = malloc(lengthu + 1);
-    if (str->body.storage_type == MVM_STRING_GRAPHEME_ASCII) {
-        /* No encoding needed; directly copy. */
-        memcpy(result, str->body.storage.blob_ascii, lengthu);
-        result[lengthu] = 0;
-    }
-    else {
-        MVMuint32 i = 0;
-        MVMCodepointIter ci;
-        MVM_string_ci_init(tc, &ci, str);
-        while (MVM_string_ci_has_more(tc, &ci)) {
-            MVMCodepoint ord = MVM_string_ci_get_codepoint(tc, &ci);
-            if (ord >= 0 && ord <= 255)
-                result[i] = (MVMuint8)ord;
-            else
-                result[i] = '?';
-            i++;
-        }
-        result[i] = 0;
-    }
     if (output_size)
         *output_size = lengthu;
+
     return result;
 }
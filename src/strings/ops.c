@@ -1,4 +1,7 @@
 #include "moar.h"
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
 
 #define MVM_DEBUG_STRANDS 0
 
@@ -38,28 +41,187 @@ static void copy_strands(MVMThreadContext *tc, MVMString *from, MVMuint16 from_o
         num_strands * sizeof(MVMStringStrand));
 }
 
+/* Checks if all of a string's graphemes are held in 8-bit storage, either
+ * directly or in the strings its strands refer to. */
+static MVMint32 is_8bit(MVMThreadContext *tc, MVMString *s) {
+    MVMuint16 i;
+    switch (s->body.storage_type) {
+    case MVM_STRING_GRAPHEME_ASCII:
+    case MVM_STRING_GRAPHEME_8:
+        return 1;
+    case MVM_STRING_STRAND:
+        for (i = 0; i < s->body.num_strands; i++)
+            if (s->body.storage.strands[i].blob_string->body.storage_type == MVM_STRING_GRAPHEME_32)
+                return 0;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+/* Gives a string a flat buffer of graphemes, starting at the specified
+ * grapheme of another string, in 8-bit storage if they all fit in it or
+ * 32-bit storage otherwise. */
+static void copy_to_flat(MVMThreadContext *tc, MVMString *to, MVMString *from, MVMuint32 start) {
+    MVMuint32       graphs = to->body.num_graphs;
+    MVMuint32       i;
+    MVMGraphemeIter gi;
+    MVM_string_gi_init(tc, &gi, from);
+    MVM_string_gi_move_to(tc, &gi, start);
+    if (is_8bit(tc, from)) {
+        to->body.storage_type   = MVM_STRING_GRAPHEME_8;
+        to->body.storage.blob_8 = malloc(graphs);
+        for (i = 0; i < graphs; i++)
+            to->body.storage.blob_8[i] = (MVMGrapheme8)MVM_string_gi_get_grapheme(tc, &gi);
+    }
+    else {
+        to->body.storage_type    = MVM_STRING_GRAPHEME_32;
+        to->body.storage.blob_32 = malloc(graphs * sizeof(MVMGrapheme32));
+        for (i = 0; i < graphs; i++)
+            to->body.storage.blob_32[i] = MVM_string_gi_get_grapheme(tc, &gi);
+    }
+}
+
+/* Sets a buffer of 32-bit graphemes as the storage of a string, taking
+ * ownership of it. If all of the graphemes fit in 8 bits, they are stored
+ * that way instead and the buffer is freed. */
+void MVM_string_set_blob_32(MVMThreadContext *tc, MVMString *s, MVMGrapheme32 *blob, MVMuint32 graphs) {
+    MVMuint32 i;
+    s->body.num_graphs = graphs;
+    for (i = 0; i < graphs; i++)
+        if (blob[i] < 0 || blob[i] > 255)
+            break;
+    if (i == graphs) {
+        MVMGrapheme8 *blob_8 = malloc(graphs);
+        for (i = 0; i < graphs; i++)
+            blob_8[i] = (MVMGrapheme8)blob[i];
+        free(blob);
+        s->body.storage_type   = MVM_STRING_GRAPHEME_8;
+        s->body.storage.blob_8 = blob_8;
+    }
+    else {
+        s->body.storage_type    = MVM_STRING_GRAPHEME_32;
+        s->body.storage.blob_32 = blob;
+    }
+}
+
 /* Collapses a bunch of strands into a single blob string. */
 MVMString * collapse_strands(MVMThreadContext *tc, MVMString *orig) {
-    MVMString       *result;
-    MVMStringIndex   i;
-    MVMuint32        ographs;
-    MVMGraphemeIter  gi;
+    MVMString *result;
 
     MVMROOT(tc, orig, {
         result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
     });
-    ographs                      = MVM_string_graphs(tc, orig);
-    result->body.num_graphs      = ographs;
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.storage.blob_32 = malloc(ographs * sizeof(MVMGrapheme32));
-
-    MVM_string_gi_init(tc, &gi, orig);
-    for (i = 0; i < ographs; i++)
-        result->body.storage.blob_32[i] = MVM_string_gi_get_grapheme(tc, &gi);
+    result->body.num_graphs = MVM_string_graphs(tc, orig);
+    copy_to_flat(tc, result, orig, 0);
 
     return result;
 }
 
+/* Number of graphemes a strand stands for, counting its repetitions. */
+static MVMuint32 strand_graphs(MVMStringStrand *ss) {
+    return (ss->end - ss->start) * (ss->repetitions + 1);
+}
+
+/* Groups a run of strands, whose sizes are given in the order they are to
+ * be visited, by stacking them up and merging the top two whenever the
+ * lower is no bigger than twice the upper (much like Timsort does with its
+ * runs). The group sizes left on the stack more than double each step down,
+ * so there are few of them. Writes each group's size and strand count, in
+ * stack order, and returns how many groups there are. */
+static MVMuint16 stack_strand_groups(MVMuint32 *sizes, MVMint32 from, MVMint32 step,
+        MVMuint16 num, MVMuint32 *group_sizes, MVMuint16 *group_counts) {
+    MVMuint16 groups = 0;
+    MVMuint16 i;
+    for (i = 0; i < num; i++) {
+        group_sizes[groups]  = sizes[from + i * step];
+        group_counts[groups] = 1;
+        groups++;
+        while (groups > 1 &&
+                group_sizes[groups - 2] <= 2 * (MVMuint64)group_sizes[groups - 1]) {
+            group_sizes[groups - 2]  += group_sizes[groups - 1];
+            group_counts[groups - 2] += group_counts[groups - 1];
+            groups--;
+        }
+    }
+    return groups;
+}
+
+/* Brings a strand string that has gone over MVM_STRING_MAX_STRANDS back
+ * under it by collapsing runs of neighbouring strands into flat strings.
+ * Strands are grouped outwards from the biggest one in each direction, so
+ * that strand sizes shrink geometrically towards both ends of the string.
+ * That way, building up a string by repeated appends (or prepends) copies
+ * each grapheme O(log n) times, where collapsing the whole string every
+ * MVM_STRING_MAX_STRANDS concatenations copied it O(n) times. Allocating
+ * the flat strings may move the string, so callers must root their own
+ * reference to it. */
+static void rebalance_strands(MVMThreadContext *tc, MVMString *s) {
+    MVMStringStrand *strands = s->body.storage.strands;
+    MVMuint16        num     = s->body.num_strands;
+    MVMuint32        sizes[2 * MVM_STRING_MAX_STRANDS];
+    MVMuint32        group_sizes[2 * MVM_STRING_MAX_STRANDS];
+    MVMuint16        group_counts[2 * MVM_STRING_MAX_STRANDS];
+    MVMuint32        offset;
+    MVMuint16        biggest = 0, left_groups, groups, first, i;
+    MVMint32         g;
+
+    for (i = 0; i < num; i++) {
+        sizes[i] = strand_graphs(&strands[i]);
+        if (sizes[i] > sizes[biggest])
+            biggest = i;
+    }
+
+    /* Strands left of the biggest are visited from it leftwards, and so
+     * get stacked in reverse; put them back in string order. */
+    left_groups = biggest
+        ? stack_strand_groups(sizes, biggest - 1, -1, biggest, group_sizes, group_counts)
+        : 0;
+    for (i = 0; i < left_groups / 2; i++) {
+        MVMuint32 size  = group_sizes[i];
+        MVMuint16 count = group_counts[i];
+        group_sizes[i]  = group_sizes[left_groups - 1 - i];
+        group_counts[i] = group_counts[left_groups - 1 - i];
+        group_sizes[left_groups - 1 - i]  = size;
+        group_counts[left_groups - 1 - i] = count;
+    }
+    groups = left_groups + stack_strand_groups(sizes, biggest, 1, num - biggest,
+        group_sizes + left_groups, group_counts + left_groups);
+
+    /* Shouldn't happen, but if it does just collapse everything. */
+    if (groups > MVM_STRING_MAX_STRANDS) {
+        group_sizes[0]  = s->body.num_graphs;
+        group_counts[0] = num;
+        groups          = 1;
+    }
+
+    /* Collapse the groups, working backwards so that the strand indexes and
+     * grapheme offsets of those still to do don't change. */
+    first  = num;
+    offset = s->body.num_graphs;
+    MVMROOT(tc, s, {
+        for (g = groups - 1; g >= 0; g--) {
+            first  -= group_counts[g];
+            offset -= group_sizes[g];
+            if (group_counts[g] > 1) {
+                MVMString       *flat;
+                MVMStringStrand *ss;
+                flat = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
+                flat->body.num_graphs = group_sizes[g];
+                copy_to_flat(tc, flat, s, offset);
+                ss = &(s->body.storage.strands[first]);
+                MVM_ASSIGN_REF(tc, &(s->common.header), ss->blob_string, flat);
+                ss->start       = 0;
+                ss->end         = group_sizes[g];
+                ss->repetitions = 0;
+                memmove(ss + 1, ss + group_counts[g],
+                    (s->body.num_strands - first - group_counts[g]) * sizeof(MVMStringStrand));
+                s->body.num_strands -= group_counts[g] - 1;
+            }
+        }
+    });
+}
+
 /* Returns nonzero if two substrings are equal, doesn't check bounds */
 MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
         MVMint64 starta, MVMint64 length, MVMString *b, MVMint64 startb) {
@@ -67,7 +229,7 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
     MVMGraphemeIter gib;
     MVMint64 i;
 
-    /* Fast paths when storage types are identical. */
+    /* Fast paths when storage types are identical, or both flat. */
     switch (a->body.storage_type) {
     case MVM_STRING_GRAPHEME_32:
         if (b->body.storage_type == MVM_STRING_GRAPHEME_32)
@@ -75,6 +237,12 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
                 a->body.storage.blob_32 + starta,
                 b->body.storage.blob_32 + startb,
                 length * sizeof(MVMGrapheme32));
+        if (b->body.storage_type != MVM_STRING_STRAND) {
+            for (i = 0; i < length; i++)
+                if (a->body.storage.blob_32[starta + i] != b->body.storage.blob_8[startb + i])
+                    return 0;
+            return 1;
+        }
         break;
     case MVM_STRING_GRAPHEME_ASCII:
     case MVM_STRING_GRAPHEME_8:
@@ -84,6 +252,12 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
                 a->body.storage.blob_8 + starta,
                 b->body.storage.blob_8 + startb,
                 length);
+        if (b->body.storage_type == MVM_STRING_GRAPHEME_32) {
+            for (i = 0; i < length; i++)
+                if (a->body.storage.blob_8[starta + i] != b->body.storage.blob_32[startb + i])
+                    return 0;
+            return 1;
+        }
         break;
     }
 
@@ -98,6 +272,61 @@ MVMint64 MVM_string_substrings_equal_nocheck(MVMThreadContext *tc, MVMString *a,
     return 1;
 }
 
+/* Gets the table of the grapheme offsets each strand of a strand string
+ * starts at, building it if this is the first random access into the
+ * string. Strand strings are not changed once other threads can see them,
+ * so a table raced in by another thread is as good as our own. */
+static MVMuint32 * strand_offsets(MVMThreadContext *tc, MVMString *s) {
+    MVMuint32 *offsets = s->body.strand_offsets;
+    if (!offsets) {
+        MVMStringStrand *strands = s->body.storage.strands;
+        MVMuint16        num     = s->body.num_strands;
+        MVMuint32        offset  = 0;
+        MVMuint16        i;
+        offsets = malloc((num + 1) * sizeof(MVMuint32));
+        for (i = 0; i < num; i++) {
+            offsets[i] = offset;
+            offset    += strand_graphs(&strands[i]);
+        }
+        offsets[num] = offset;
+        if (MVM_casptr(&(s->body.strand_offsets), NULL, offsets) != NULL) {
+            free(offsets);
+            offsets = s->body.strand_offsets;
+        }
+    }
+    return offsets;
+}
+
+/* Finds the strand that a (valid) grapheme index of a strand string falls
+ * in. Tries the strand the last lookup found and the one after it first,
+ * so walking through a string costs no more than a couple of compares per
+ * grapheme, then falls back to a binary search over the offset table. */
+static MVMuint16 find_strand(MVMThreadContext *tc, MVMString *s, MVMStringIndex idx) {
+    MVMuint32 *offsets;
+    MVMuint16  num = s->body.num_strands;
+    MVMuint16  lo, hi;
+    if (num == 1)
+        return 0;
+    offsets = strand_offsets(tc, s);
+    lo      = s->body.last_strand;
+    if (lo < num && offsets[lo] <= idx) {
+        if (idx < offsets[lo + 1])
+            return lo;
+        if (lo + 1 < num && idx < offsets[lo + 2])
+            return s->body.last_strand = lo + 1;
+    }
+    lo = 0;
+    hi = num - 1;
+    while (lo < hi) {
+        MVMuint16 mid = (lo + hi + 1) / 2;
+        if (offsets[mid] <= idx)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return s->body.last_strand = lo;
+}
+
 /* Returns the codepoint without doing checks, for internal VM use only. */
 MVMGrapheme32 MVM_string_get_grapheme_at_nocheck(MVMThreadContext *tc, MVMString *a, MVMint64 index) {
     MVMStringIndex idx = (MVMStringIndex)index;
@@ -109,20 +338,266 @@ MVMGrapheme32 MVM_string_get_grapheme_at_nocheck(MVMThreadContext *tc, MVMString
     case MVM_STRING_GRAPHEME_8:
         return a->body.storage.blob_8[index];
     case MVM_STRING_STRAND: {
-        MVMGraphemeIter gi;
-        MVM_string_gi_init(tc, &gi, a);
-        MVM_string_gi_move_to(tc, &gi, index);
-        return MVM_string_gi_get_grapheme(tc, &gi);
+        MVMStringStrand *ss  = &(a->body.storage.strands[find_strand(tc, a, idx)]);
+        MVMStringIndex   pos = idx - (a->body.num_strands > 1
+            ? a->body.strand_offsets[ss - a->body.storage.strands]
+            : 0);
+        if (ss->repetitions)
+            pos %= ss->end - ss->start;
+        pos += ss->start;
+        switch (ss->blob_string->body.storage_type) {
+        case MVM_STRING_GRAPHEME_32:
+            return ss->blob_string->body.storage.blob_32[pos];
+        case MVM_STRING_GRAPHEME_ASCII:
+            return ss->blob_string->body.storage.blob_ascii[pos];
+        case MVM_STRING_GRAPHEME_8:
+            return ss->blob_string->body.storage.blob_8[pos];
+        }
     }
     default:
         MVM_exception_throw_adhoc(tc, "String corruption detected: bad storage type");
     }
 }
 
+/* Substring search works on flat buffers of graphemes. A needle shorter than
+ * this is found by scanning for its first grapheme and comparing wherever it
+ * turns up; longer ones are searched for with Boyer-Moore-Horspool. */
+#define MVM_STRING_HORSPOOL_MIN 4
+
+/* How many possible match positions of a strand haystack are flattened for
+ * searching at a time. */
+#define MVM_STRING_SEARCH_WINDOW 4096
+
+/* A run of a string's graphemes in flat storage. For strings that already
+ * are flat, this borrows their buffer; strand strings are copied into a
+ * 32-bit buffer, which must be freed afterwards. */
+typedef struct {
+    MVMuint8      *blob_8;
+    MVMGrapheme32 *blob_32;
+    MVMint64       offset;
+    MVMint64       length;
+    void          *to_free;
+} FlatGraphemes;
+
+/* Gets graphemes from..to of a string as a flat run. */
+static void flatten_for_search(MVMThreadContext *tc, MVMString *s, MVMint64 from, MVMint64 to, FlatGraphemes *fg) {
+    fg->blob_8  = NULL;
+    fg->blob_32 = NULL;
+    fg->offset  = from;
+    fg->length  = to - from;
+    fg->to_free = NULL;
+    switch (s->body.storage_type) {
+    case MVM_STRING_GRAPHEME_32:
+        fg->blob_32 = s->body.storage.blob_32 + from;
+        break;
+    case MVM_STRING_GRAPHEME_ASCII:
+    case MVM_STRING_GRAPHEME_8:
+        fg->blob_8 = (MVMuint8 *)s->body.storage.blob_8 + from;
+        break;
+    default: {
+        MVMGraphemeIter gi;
+        MVMint64        i;
+        fg->blob_32 = fg->to_free = malloc(fg->length * sizeof(MVMGrapheme32));
+        MVM_string_gi_init(tc, &gi, s);
+        MVM_string_gi_move_to(tc, &gi, from);
+        for (i = 0; i < fg->length; i++)
+            fg->blob_32[i] = MVM_string_gi_get_grapheme(tc, &gi);
+    }
+    }
+}
+
+/* Makes a needle use the same width of storage as the haystack. Returns zero
+ * if the needle holds graphemes that cannot appear in the haystack. */
+static MVMint64 match_needle_width(MVMThreadContext *tc, FlatGraphemes *needle, FlatGraphemes *haystack) {
+    MVMint64 i;
+    if (haystack->blob_8 && needle->blob_32) {
+        MVMGrapheme32 *blob_32 = needle->blob_32;
+        MVMuint8      *blob_8;
+        for (i = 0; i < needle->length; i++)
+            if (blob_32[i] < 0 || blob_32[i] > 255)
+                return 0;
+        blob_8 = malloc(needle->length);
+        for (i = 0; i < needle->length; i++)
+            blob_8[i] = (MVMuint8)blob_32[i];
+        free(needle->to_free);
+        needle->blob_8  = needle->to_free = blob_8;
+        needle->blob_32 = NULL;
+    }
+    else if (haystack->blob_32 && needle->blob_8) {
+        MVMGrapheme32 *blob_32 = malloc(needle->length * sizeof(MVMGrapheme32));
+        for (i = 0; i < needle->length; i++)
+            blob_32[i] = (MVMGrapheme8)needle->blob_8[i];
+        needle->blob_32 = needle->to_free = blob_32;
+        needle->blob_8  = NULL;
+    }
+    return 1;
+}
+
+/* Finds the first occurrence of n in h at or after start. */
+static MVMint64 index_8(const MVMuint8 *h, MVMint64 hlen, const MVMuint8 *n, MVMint64 nlen, MVMint64 start) {
+    if (nlen < MVM_STRING_HORSPOOL_MIN) {
+        const MVMuint8 *pos  = h + start;
+        const MVMuint8 *last = h + hlen - nlen;
+        while (pos <= last) {
+            pos = memchr(pos, n[0], last - pos + 1);
+            if (!pos)
+                break;
+            if (memcmp(pos, n, nlen) == 0)
+                return pos - h;
+            pos++;
+        }
+    }
+    else {
+        MVMint64 shift[256];
+        MVMint64 i, pos;
+        for (i = 0; i < 256; i++)
+            shift[i] = nlen;
+        for (i = 0; i < nlen - 1; i++)
+            shift[n[i]] = nlen - 1 - i;
+        for (pos = start; pos <= hlen - nlen; pos += shift[h[pos + nlen - 1]])
+            if (h[pos + nlen - 1] == n[nlen - 1] && memcmp(h + pos, n, nlen - 1) == 0)
+                return pos;
+    }
+    return -1;
+}
+
+/* Finds the last occurrence of n in h starting at or before start. */
+static MVMint64 rindex_8(const MVMuint8 *h, const MVMuint8 *n, MVMint64 nlen, MVMint64 start) {
+    MVMint64 pos = start;
+    if (nlen < MVM_STRING_HORSPOOL_MIN) {
+        for (; pos >= 0; pos--)
+            if (h[pos] == n[0] && memcmp(h + pos, n, nlen) == 0)
+                return pos;
+    }
+    else {
+        MVMint64 shift[256];
+        MVMint64 i;
+        for (i = 0; i < 256; i++)
+            shift[i] = nlen;
+        for (i = nlen - 1; i > 0; i--)
+            shift[n[i]] = i;
+        for (; pos >= 0; pos -= shift[h[pos]])
+            if (h[pos] == n[0] && memcmp(h + pos + 1, n + 1, nlen - 1) == 0)
+                return pos;
+    }
+    return -1;
+}
+
+/* As index_8, but for 32-bit graphemes; the shift table is indexed by the
+ * low byte of each grapheme, keeping the smallest shift on collisions. */
+static MVMint64 index_32(const MVMGrapheme32 *h, MVMint64 hlen, const MVMGrapheme32 *n, MVMint64 nlen, MVMint64 start) {
+    MVMint64 pos;
+    if (nlen < MVM_STRING_HORSPOOL_MIN) {
+        for (pos = start; pos <= hlen - nlen; pos++)
+            if (h[pos] == n[0] && memcmp(h + pos, n, nlen * sizeof(MVMGrapheme32)) == 0)
+                return pos;
+    }
+    else {
+        MVMint64 shift[256];
+        MVMint64 i;
+        for (i = 0; i < 256; i++)
+            shift[i] = nlen;
+        for (i = 0; i < nlen - 1; i++)
+            shift[n[i] & 0xFF] = nlen - 1 - i;
+        for (pos = start; pos <= hlen - nlen; pos += shift[h[pos + nlen - 1] & 0xFF])
+            if (h[pos + nlen - 1] == n[nlen - 1]
+                    && memcmp(h + pos, n, (nlen - 1) * sizeof(MVMGrapheme32)) == 0)
+                return pos;
+    }
+    return -1;
+}
+
+/* As rindex_8, but for 32-bit graphemes. */
+static MVMint64 rindex_32(const MVMGrapheme32 *h, const MVMGrapheme32 *n, MVMint64 nlen, MVMint64 start) {
+    MVMint64 pos = start;
+    if (nlen < MVM_STRING_HORSPOOL_MIN) {
+        for (; pos >= 0; pos--)
+            if (h[pos] == n[0] && memcmp(h + pos, n, nlen * sizeof(MVMGrapheme32)) == 0)
+                return pos;
+    }
+    else {
+        MVMint64 shift[256];
+        MVMint64 i;
+        for (i = 0; i < 256; i++)
+            shift[i] = nlen;
+        for (i = nlen - 1; i > 0; i--)
+            shift[n[i] & 0xFF] = i;
+        for (; pos >= 0; pos -= shift[h[pos] & 0xFF])
+            if (h[pos] == n[0]
+                    && memcmp(h + pos + 1, n + 1, (nlen - 1) * sizeof(MVMGrapheme32)) == 0)
+                return pos;
+    }
+    return -1;
+}
+
+/* Searches a flattened haystack for a needle of matching width, forwards
+ * from or backwards from the string index start. Returns the string index
+ * of the match, or -1 if there is none. */
+static MVMint64 search_flat(FlatGraphemes *h, FlatGraphemes *n, MVMint64 start, MVMint64 backwards) {
+    MVMint64 result;
+    start -= h->offset;
+    if (h->blob_8)
+        result = backwards
+            ? rindex_8(h->blob_8, n->blob_8, n->length, start)
+            : index_8(h->blob_8, h->length, n->blob_8, n->length, start);
+    else
+        result = backwards
+            ? rindex_32(h->blob_32, n->blob_32, n->length, start)
+            : index_32(h->blob_32, h->length, n->blob_32, n->length, start);
+    return result == -1 ? -1 : result + h->offset;
+}
+
+/* Finds a needle in the graphemes from..to of a haystack, forwards from or
+ * backwards from start. A strand haystack is flattened a window at a time,
+ * so a search that finds a match soon, as each in a loop of index calls
+ * does, only copies about as much as it looks at. */
+static MVMint64 search(MVMThreadContext *tc, MVMString *haystack, MVMint64 from, MVMint64 to,
+        MVMString *needle, MVMint64 start, MVMint64 backwards) {
+    FlatGraphemes h, n;
+    MVMint64      result = -1;
+    flatten_for_search(tc, needle, 0, MVM_string_graphs(tc, needle), &n);
+    if (haystack->body.storage_type != MVM_STRING_STRAND) {
+        flatten_for_search(tc, haystack, from, to, &h);
+        if (match_needle_width(tc, &n, &h))
+            result = search_flat(&h, &n, start, backwards);
+        free(h.to_free);
+    }
+    else if (!backwards) {
+        /* Each window holds the matches starting in its first
+         * MVM_STRING_SEARCH_WINDOW graphemes. */
+        MVMint64 win_from = start;
+        while (result == -1 && win_from + n.length <= to) {
+            MVMint64 win_to = win_from + MVM_STRING_SEARCH_WINDOW + n.length - 1;
+            if (win_to > to)
+                win_to = to;
+            flatten_for_search(tc, haystack, win_from, win_to, &h);
+            if (match_needle_width(tc, &n, &h))
+                result = search_flat(&h, &n, win_from, 0);
+            free(h.to_free);
+            win_from += MVM_STRING_SEARCH_WINDOW;
+        }
+    }
+    else {
+        /* Likewise, but for the matches starting in its last window's worth
+         * of graphemes, up to the latest place one may start. */
+        MVMint64 last = start;
+        while (result == -1 && last >= from) {
+            MVMint64 win_from = last - MVM_STRING_SEARCH_WINDOW + 1;
+            if (win_from < from)
+                win_from = from;
+            flatten_for_search(tc, haystack, win_from, last + n.length, &h);
+            if (match_needle_width(tc, &n, &h))
+                result = search_flat(&h, &n, last, 1);
+            free(h.to_free);
+            last = win_from - 1;
+        }
+    }
+    free(n.to_free);
+    return result;
+}
+
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start) {
-    MVMint64 result        = -1;
-    size_t index           = (size_t)start;
     MVMStringIndex hgraphs = MVM_string_graphs(tc, haystack), ngraphs = MVM_string_graphs(tc, needle);
 
     if (!IS_CONCRETE((MVMObject *)haystack)) {
@@ -145,21 +620,11 @@ MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *haystack, MVMString *
     if (ngraphs > hgraphs || ngraphs < 1)
         return -1;
 
-    /* brute force for now. horrible, yes. halp. */
-    while (index <= hgraphs - ngraphs) {
-        if (MVM_string_substrings_equal_nocheck(tc, needle, 0, ngraphs, haystack, index)) {
-            result = (MVMint64)index;
-            break;
-        }
-        index++;
-    }
-    return result;
+    return search(tc, haystack, start, hgraphs, needle, start, 0);
 }
 
 /* Returns the location of one string in another or -1  */
 MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start) {
-    MVMint64 result = -1;
-    size_t index;
     MVMStringIndex hgraphs = MVM_string_graphs(tc, haystack), ngraphs = MVM_string_graphs(tc, needle);
 
     if (!IS_CONCRETE((MVMObject *)haystack)) {
@@ -186,16 +651,11 @@ MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *haystack, MV
     if (ngraphs > hgraphs || ngraphs < 1)
         return -1;
 
-    index = start;
+    /* A match can start no later than ngraphs from the end. */
+    if (start > hgraphs - ngraphs)
+        start = hgraphs - ngraphs;
 
-    /* brute force for now. horrible, yes. halp. */
-    do {
-        if (MVM_string_substrings_equal_nocheck(tc, needle, 0, ngraphs, haystack, index)) {
-            result = (MVMint64)index;
-            break;
-        }
-    } while (index-- > 0);
-    return result;
+    return search(tc, haystack, 0, start + ngraphs, needle, start, 1);
 }
 
 /* Returns a substring of the given string */
@@ -268,14 +728,7 @@ MVMString * MVM_string_substring(MVMThreadContext *tc, MVMString *a, MVMint64 of
         }
         else {
             /* Produce a new blob string, collapsing the strands. */
-            MVMGraphemeIter gi;
-            MVMint32 i;
-            result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-            result->body.storage.blob_32 = malloc(result->body.num_graphs * sizeof(MVMGrapheme32));
-            MVM_string_gi_init(tc, &gi, a);
-            MVM_string_gi_move_to(tc, &gi, start_pos);
-            for (i = 0; i < result->body.num_graphs; i++)
-                result->body.storage.blob_32[i] = MVM_string_gi_get_grapheme(tc, &gi);
+            copy_to_flat(tc, result, a, start_pos);
         }
     });
 
@@ -352,52 +805,44 @@ MVMString * MVM_string_concatenate(MVMThreadContext *tc, MVMString *a, MVMString
             result->body.num_strands = a->body.num_strands;
         }
 
-        /* Otherwise, construct a new strand string. */
+        /* Otherwise, construct a new strand string. If that takes us over
+         * the strand limit, rebalance it afterwards. */
         else {
-            /* See if we have too many strands between the two. If so, we will
-             * collapse the biggest side. */
             MVMuint16 strands_a = a->body.storage_type == MVM_STRING_STRAND
                 ? a->body.num_strands
                 : 1;
             MVMuint16 strands_b = b->body.storage_type == MVM_STRING_STRAND
                 ? b->body.num_strands
                 : 1;
-            MVMString *effective_a = a;
-            MVMString *effective_b = b;
-            if (strands_a + strands_b > MVM_STRING_MAX_STRANDS) {
-                if (strands_a >= strands_b) {
-                    effective_a = collapse_strands(tc, effective_a);
-                    strands_a   = 1;
-                }
-                else {
-                    effective_b = collapse_strands(tc, effective_b);
-                    strands_b   = 1;
-                }
-            }
 
             /* Assemble the result. */
             result->body.num_strands = strands_a + strands_b;
             result->body.storage.strands = allocate_strands(tc, strands_a + strands_b);
-            if (effective_a->body.storage_type == MVM_STRING_STRAND) {
-                copy_strands(tc, effective_a, 0, result, 0, strands_a);
+            if (a->body.storage_type == MVM_STRING_STRAND) {
+                copy_strands(tc, a, 0, result, 0, strands_a);
             }
             else {
                 MVMStringStrand *ss = &(result->body.storage.strands[0]);
-                ss->blob_string = effective_a;
+                ss->blob_string = a;
                 ss->start       = 0;
-                ss->end         = effective_a->body.num_graphs;
+                ss->end         = a->body.num_graphs;
                 ss->repetitions = 0;
             }
-            if (effective_b->body.storage_type == MVM_STRING_STRAND) {
-                copy_strands(tc, effective_b, 0, result, strands_a, strands_b);
+            if (b->body.storage_type == MVM_STRING_STRAND) {
+                copy_strands(tc, b, 0, result, strands_a, strands_b);
             }
             else {
                 MVMStringStrand *ss = &(result->body.storage.strands[strands_a]);
-                ss->blob_string = effective_b;
+                ss->blob_string = b;
                 ss->start       = 0;
-                ss->end         = effective_b->body.num_graphs;
+                ss->end         = b->body.num_graphs;
                 ss->repetitions = 0;
             }
+            if (result->body.num_strands > MVM_STRING_MAX_STRANDS) {
+                MVMROOT(tc, result, {
+                    rebalance_strands(tc, result);
+                });
+            }
         }
     });
     });
@@ -528,11 +973,66 @@ MVMint64 MVM_string_equal_at_ignore_case(MVMThreadContext *tc, MVMString *a, MVM
 MVMint64 MVM_string_equal(MVMThreadContext *tc, MVMString *a, MVMString *b) {
     if (a == b)
         return 1;
+    if (a->body.interned && b->body.interned)
+        return 0;
     if (MVM_string_graphs(tc, a) != MVM_string_graphs(tc, b))
         return 0;
+    if (a->body.cached_hash_code && b->body.cached_hash_code &&
+            a->body.cached_hash_code != b->body.cached_hash_code)
+        return 0;
     return MVM_string_equal_at(tc, a, b, 0);
 }
 
+/* Computes a hash code over the graphemes of a string (Jenkins' one at a
+ * time, taking a grapheme at a time), so the result does not depend on how
+ * the string happens to be stored. It is cached in the string; 0 means not
+ * yet computed, so is never returned. */
+MVMuint32 MVM_string_hash_code(MVMThreadContext *tc, MVMString *s) {
+    MVMuint32 hash = (MVMuint32)s->body.cached_hash_code;
+    MVMuint32 i, length;
+    if (hash)
+        return hash;
+    length = MVM_string_graphs(tc, s);
+    switch (s->body.storage_type) {
+    case MVM_STRING_GRAPHEME_32: {
+        MVMGrapheme32 *blob = s->body.storage.blob_32;
+        for (i = 0; i < length; i++) {
+            hash += (MVMuint32)blob[i];
+            hash += hash << 10;
+            hash ^= hash >> 6;
+        }
+        break;
+    }
+    case MVM_STRING_GRAPHEME_ASCII:
+    case MVM_STRING_GRAPHEME_8: {
+        MVMGrapheme8 *blob = s->body.storage.blob_8;
+        for (i = 0; i < length; i++) {
+            hash += blob[i];
+            hash += hash << 10;
+            hash ^= hash >> 6;
+        }
+        break;
+    }
+    case MVM_STRING_STRAND: {
+        MVMGraphemeIter gi;
+        MVM_string_gi_init(tc, &gi, s);
+        while (MVM_string_gi_has_more(tc, &gi)) {
+            hash += (MVMuint32)MVM_string_gi_get_grapheme(tc, &gi);
+            hash += hash << 10;
+            hash ^= hash >> 6;
+        }
+        break;
+    }
+    }
+    hash += hash << 3;
+    hash ^= hash >> 11;
+    hash += hash << 15;
+    if (!hash)
+        hash = 1;
+    s->body.cached_hash_code = (MVMint32)hash;
+    return hash;
+}
+
 /* more general form of has_at; compares two substrings for equality */
 MVMint64 MVM_string_have_at(MVMThreadContext *tc, MVMString *a,
         MVMint64 starta, MVMint64 length, MVMString *b, MVMint64 startb) {
@@ -613,9 +1113,7 @@ MVMString * funcname(MVMThreadContext *tc, MVMString *s) { \
         } \
         if (changed) { \
             result = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString); \
-            result->body.num_graphs      = sgraphs; \
-            result->body.storage_type    = MVM_STRING_GRAPHEME_32; \
-            result->body.storage.blob_32 = result_buf; \
+            MVM_string_set_blob_32(tc, result, result_buf, sgraphs); \
             return result; \
         } \
         else { \
@@ -649,6 +1147,63 @@ MVMString * MVM_string_decode(MVMThreadContext *tc,
     return NULL;
 }
 
+/* Checks the start and length given to an encoder, resolving a length of
+ * -1 to the rest of the string. */
+MVMuint32 MVM_string_check_encode_range(MVMThreadContext *tc, MVMString *s,
+        MVMint64 start, MVMint64 length) {
+    MVMStringIndex strgraphs = MVM_string_graphs(tc, s);
+
+    /* must check start first since it's used in the length check */
+    if (start < 0 || start > strgraphs)
+        MVM_exception_throw_adhoc(tc, "start out of range");
+    if (length == -1)
+        length = strgraphs - start;
+    if (length < 0 || start + length > strgraphs)
+        MVM_exception_throw_adhoc(tc, "length out of range");
+
+    return (MVMuint32)length;
+}
+
+/* Encodes a range checked substring to a single byte encoding whose first
+ * max + 1 codepoints are those of Unicode, such as ASCII or latin-1; each
+ * grapheme becomes a byte, and anything beyond max becomes a ?. Works a
+ * strand at a time, so ropes need not be flattened first. */
+void MVM_string_encode_range_bytes(MVMThreadContext *tc, MVMString *s, MVMuint32 start,
+        MVMuint32 length, MVMuint8 *out, MVMuint8 max) {
+    MVMGraphemeIter gi;
+    MVMuint32       done = 0;
+    MVM_string_gi_init(tc, &gi, s);
+    MVM_string_gi_move_to(tc, &gi, start);
+    while (done < length) {
+        MVMuint16  type;
+        void      *run;
+        MVMuint32  n = MVM_string_gi_next_run(tc, &gi, length - done, &type, &run);
+        MVMuint32  i;
+        switch (type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+            memcpy(out, run, n);
+            break;
+        case MVM_STRING_GRAPHEME_8: {
+            MVMGrapheme8 *blob = (MVMGrapheme8 *)run;
+            if (max == 255)
+                memcpy(out, blob, n);
+            else
+                for (i = 0; i < n; i++)
+                    out[i] = blob[i] <= max ? blob[i] : '?';
+            break;
+        }
+        case MVM_STRING_GRAPHEME_32: {
+            MVMGrapheme32 *blob = (MVMGrapheme32 *)run;
+            for (i = 0; i < n; i++)
+                out[i] = (MVMuint32)blob[i] <= max ? (MVMuint8)blob[i] : '?';
+            break;
+        }
+        }
+        out  += n;
+        done += n;
+    }
+}
+
 /* Encodes an MVMString to a C buffer, dependent on the encoding type flag */
 MVMuint8 * MVM_string_encode(MVMThreadContext *tc, MVMString *s, MVMint64 start, MVMint64 length, MVMuint64 *output_size, MVMint64 encoding_flag) {
     switch(encoding_flag) {
@@ -753,27 +1308,35 @@ MVMObject * MVM_string_split(MVMThreadContext *tc, MVMString *separator, MVMStri
     MVMObject *result;
     MVMStringIndex start, end, sep_length;
     MVMHLLConfig *hll = MVM_hll_current(tc);
+    FlatGraphemes flat_input, flat_sep;
+    MVMint64 can_match;
 
     if (!IS_CONCRETE((MVMObject *)separator)) {
         MVM_exception_throw_adhoc(tc, "split needs a concrete string separator");
     }
 
+    /* Flatten the input and separator just once for all the searches. The
+     * buffers are not GC-managed, so stay put while we allocate. */
+    end        = MVM_string_graphs(tc, input);
+    sep_length = MVM_string_graphs(tc, separator);
+    flatten_for_search(tc, input, 0, end, &flat_input);
+    flatten_for_search(tc, separator, 0, sep_length, &flat_sep);
+    can_match = match_needle_width(tc, &flat_sep, &flat_input);
+
     MVMROOT(tc, input, {
     MVMROOT(tc, separator, {
         result = MVM_repr_alloc_init(tc, hll->slurpy_array_type);
         MVMROOT(tc, result, {
             start = 0;
-            end = MVM_string_graphs(tc, input);
-            sep_length = MVM_string_graphs(tc, separator);
 
             while (start < end) {
                 MVMString *portion;
-                MVMStringIndex index;
+                MVMint64 index;
                 MVMStringIndex length;
 
-                /* XXX make this use the dual-traverse iterator, but such that it
-                    can reset the index of what it's comparing... <!> */
-                index = MVM_string_index(tc, input, separator, start);
+                index = sep_length && can_match && sep_length <= end - start
+                    ? search_flat(&flat_input, &flat_sep, start, 0)
+                    : -1;
                 length = sep_length ? (index == -1 ? end : index) - start : 1;
                 if (length > 0 || (sep_length && length == 0)) {
                     portion = MVM_string_substring(tc, input, start, length);
@@ -795,14 +1358,51 @@ MVMObject * MVM_string_split(MVMThreadContext *tc, MVMString *separator, MVMStri
     });
     });
 
+    free(flat_input.to_free);
+    free(flat_sep.to_free);
     return result;
 }
 
+/* Copies a string's graphemes into the flat storage of another at the
+ * specified position, returning the position after them. */
+static MVMint64 append_to_flat(MVMThreadContext *tc, MVMString *to, MVMint64 position, MVMString *from) {
+    MVMuint32       graphs = MVM_string_graphs(tc, from);
+    MVMGraphemeIter gi;
+    if (to->body.storage_type == MVM_STRING_GRAPHEME_8) {
+        switch (from->body.storage_type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+        case MVM_STRING_GRAPHEME_8:
+            memcpy(to->body.storage.blob_8 + position, from->body.storage.blob_8, graphs);
+            return position + graphs;
+        default:
+            MVM_string_gi_init(tc, &gi, from);
+            while (MVM_string_gi_has_more(tc, &gi))
+                to->body.storage.blob_8[position++] =
+                    (MVMGrapheme8)MVM_string_gi_get_grapheme(tc, &gi);
+            return position;
+        }
+    }
+    else {
+        switch (from->body.storage_type) {
+        case MVM_STRING_GRAPHEME_32:
+            memcpy(to->body.storage.blob_32 + position, from->body.storage.blob_32,
+                graphs * sizeof(MVMGrapheme32));
+            return position + graphs;
+        default:
+            MVM_string_gi_init(tc, &gi, from);
+            while (MVM_string_gi_has_more(tc, &gi))
+                to->body.storage.blob_32[position++] = MVM_string_gi_get_grapheme(tc, &gi);
+            return position;
+        }
+    }
+}
+
 MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObject *input) {
     MVMString  *result;
     MVMString **pieces;
     MVMint64    elems, num_pieces, sgraphs, i, is_str_array, total_graphs;
     MVMuint16   sstrands, total_strands;
+    MVMint32    all_8bit;
 
     if (!IS_CONCRETE(input)) {
         MVM_exception_throw_adhoc(tc, "join needs a concrete array to join");
@@ -837,6 +1437,7 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
             : 1;
     else
         sstrands = 1;
+    all_8bit      = !sgraphs || is_8bit(tc, separator);
     pieces        = malloc(elems * sizeof(MVMString *));
     num_pieces    = 0;
     total_graphs  = 0;
@@ -870,6 +1471,8 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
                 ? piece->body.num_strands
                 : 1;
             total_graphs += piece_graphs;
+            if (all_8bit && !is_8bit(tc, piece))
+                all_8bit = 0;
         }
 
         /* Store piece. */
@@ -877,8 +1480,10 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
     }
 
     /* We now know the total eventual number of graphemes. */
-    if (total_graphs == 0)
+    if (total_graphs == 0) {
+        free(pieces);
         return tc->instance->str_consts.empty;
+    }
     result->body.num_graphs = total_graphs;
 
     /* If we just collect all the things as strands, are we within bounds, and
@@ -888,57 +1493,26 @@ MVMString * MVM_string_join(MVMThreadContext *tc, MVMString *separator, MVMObjec
     }
     /*else {*/
     if (1) {
-        /* We'll produce a single, flat string. */
-        MVMint64        position = 0;
-        MVMGraphemeIter gi;
-        result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-        result->body.storage.blob_32 = malloc(total_graphs * sizeof(MVMGrapheme32));
+        /* We'll produce a single, flat string, with 8-bit storage if all the
+         * pieces and the separator have it. */
+        MVMint64 position = 0;
+        if (all_8bit) {
+            result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+            result->body.storage.blob_8 = malloc(total_graphs);
+        }
+        else {
+            result->body.storage_type    = MVM_STRING_GRAPHEME_32;
+            result->body.storage.blob_32 = malloc(total_graphs * sizeof(MVMGrapheme32));
+        }
         for (i = 0; i < num_pieces; i++) {
-            /* Get piece. */
-            MVMString *piece = pieces[i];
-
-            /* Add separator if needed. */
-            if (i > 0) {
-                switch (separator->body.storage_type) {
-                case MVM_STRING_GRAPHEME_32:
-                    memcpy(
-                        result->body.storage.blob_32 + position,
-                        separator->body.storage.blob_32,
-                        sgraphs * sizeof(MVMGrapheme32));
-                    position += sgraphs;
-                    break;
-                /* XXX Can special-case 8-bit NFG and ASCII here too. */
-                default:
-                    MVM_string_gi_init(tc, &gi, separator);
-                    while (MVM_string_gi_has_more(tc, &gi))
-                        result->body.storage.blob_32[position++] =
-                            MVM_string_gi_get_grapheme(tc, &gi);
-                    break;
-                }
-            }
-
-            /* Add piece. */
-            switch (piece->body.storage_type) {
-            case MVM_STRING_GRAPHEME_32: {
-                MVMint64 pgraphs = MVM_string_graphs(tc, piece);
-                memcpy(
-                    result->body.storage.blob_32 + position,
-                    piece->body.storage.blob_32,
-                    pgraphs * sizeof(MVMGrapheme32));
-                position += pgraphs;
-                break;
-            }
-            /* XXX Can special-case 8-bit NFG and ASCII here too. */
-            default:
-                MVM_string_gi_init(tc, &gi, piece);
-                while (MVM_string_gi_has_more(tc, &gi))
-                    result->body.storage.blob_32[position++] =
-                        MVM_string_gi_get_grapheme(tc, &gi);
-                break;
-            }
+            /* Add separator if needed, then the piece. */
+            if (i > 0)
+                position = append_to_flat(tc, result, position, separator);
+            position = append_to_flat(tc, result, position, pieces[i]);
         }
     }
 
+    free(pieces);
     STRAND_CHECK(tc, result);
     return result;
 }
@@ -972,7 +1546,7 @@ MVMint64 MVM_string_char_at_in_string(MVMThreadContext *tc, MVMString *a, MVMint
         }
         break;
     case MVM_STRING_GRAPHEME_8:
-        if (search >= -128 && search <= 127) {
+        if (search >= 0 && search <= 255) {
             MVMStringIndex i;
             for (i = 0; i < bgraphs; i++)
                 if (b->body.storage.blob_8[i] == search)
@@ -1003,8 +1577,8 @@ MVMint64 MVM_string_offset_has_unicode_property_value(MVMThreadContext *tc, MVMS
         MVM_string_get_grapheme_at_nocheck(tc, s, offset), property_code, property_value_code);
 }
 
-/* Normalizes a string to a flat MVMGrapheme32 buffer, for the benefit of
- * hashing. Would rather not have to do this eventually. */
+/* Normalizes a string to a flat MVMGrapheme32 buffer. Hashing no longer
+ * needs this; it remains for the flattenropes op. */
 void MVM_string_flatten(MVMThreadContext *tc, MVMString *s) {
     switch (s->body.storage_type) {
     case MVM_STRING_GRAPHEME_32:
@@ -1032,6 +1606,9 @@ void MVM_string_flatten(MVMThreadContext *tc, MVMString *s) {
             flat[i++] = MVM_string_gi_get_grapheme(tc, &gi);
         s->body.storage.blob_32 = flat;
         s->body.storage_type    = MVM_STRING_GRAPHEME_32;
+        s->body.num_strands     = 0;
+        s->body.last_strand     = 0;
+        MVM_checked_free_null(s->body.strand_offsets);
         free(orig);
         break;
     }
@@ -1080,9 +1657,7 @@ MVMString * MVM_string_escape(MVMThreadContext *tc, MVMString *s) {
     }
 
     res = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    res->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    res->body.storage.blob_32 = buffer;
-    res->body.num_graphs      = bpos;
+    MVM_string_set_blob_32(tc, res, buffer, bpos);
 
     STRAND_CHECK(tc, res);
     return res;
@@ -1100,9 +1675,7 @@ MVMString * MVM_string_flip(MVMThreadContext *tc, MVMString *s) {
         rbuffer[--rpos] = MVM_string_get_grapheme_at_nocheck(tc, s, spos);
 
     res = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    res->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    res->body.storage.blob_32 = rbuffer;
-    res->body.num_graphs      = sgraphs;
+    MVM_string_set_blob_32(tc, res, rbuffer, sgraphs);
 
     STRAND_CHECK(tc, res);
     return res;
@@ -1151,9 +1724,7 @@ MVMString * MVM_string_bitand(MVMThreadContext *tc, MVMString *a, MVMString *b)
                    & MVM_string_get_grapheme_at_nocheck(tc, b, i));
 
     res = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    res->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    res->body.storage.blob_32 = buffer;
-    res->body.num_graphs      = sgraphs;
+    MVM_string_set_blob_32(tc, res, buffer, sgraphs);
 
     STRAND_CHECK(tc, res);
     return res;
@@ -1183,9 +1754,7 @@ MVMString * MVM_string_bitor(MVMThreadContext *tc, MVMString *a, MVMString *b) {
             buffer[i] = MVM_string_get_grapheme_at_nocheck(tc, b, i);
 
     res = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    res->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    res->body.storage.blob_32 = buffer;
-    res->body.num_graphs      = sgraphs;
+    MVM_string_set_blob_32(tc, res, buffer, sgraphs);
 
     STRAND_CHECK(tc, res);
     return res;
@@ -1215,9 +1784,7 @@ MVMString * MVM_string_bitxor(MVMThreadContext *tc, MVMString *a, MVMString *b)
             buffer[i] = MVM_string_get_grapheme_at_nocheck(tc, b, i);
 
     res = (MVMString *)MVM_repr_alloc_init(tc, tc->instance->VMString);
-    res->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    res->body.storage.blob_32 = buffer;
-    res->body.num_graphs      = sgraphs;
+    MVM_string_set_blob_32(tc, res, buffer, sgraphs);
 
     STRAND_CHECK(tc, res);
     return res;
@@ -1241,6 +1808,33 @@ static MVMint64 UPV_Pi = 0;
 static MVMint64 UPV_Pf = 0;
 static MVMint64 UPV_Po = 0;
 
+/* Membership of the character classes is kept in tables holding a mask of
+ * the MVM_CCLASS_* bits for each codepoint, split up into blocks. A block
+ * is computed from the Unicode properties when a codepoint in it is first
+ * looked up, since doing all of Unicode up front would mean over thirteen
+ * million property lookups at startup; the block holding ASCII and Latin-1
+ * is built at init. */
+#define CCLASS_BLOCK_SHIFT 8
+#define CCLASS_BLOCK_SIZE  (1 << CCLASS_BLOCK_SHIFT)
+#define CCLASS_NUM_BLOCKS  (0x110000 >> CCLASS_BLOCK_SHIFT)
+#define CCLASS_TABLED      (MVM_CCLASS_UPPERCASE | MVM_CCLASS_LOWERCASE | \
+    MVM_CCLASS_ALPHABETIC | MVM_CCLASS_NUMERIC | MVM_CCLASS_HEXADECIMAL | \
+    MVM_CCLASS_WHITESPACE | MVM_CCLASS_PRINTING | MVM_CCLASS_BLANK | \
+    MVM_CCLASS_CONTROL | MVM_CCLASS_PUNCTUATION | MVM_CCLASS_ALPHANUMERIC | \
+    MVM_CCLASS_NEWLINE | MVM_CCLASS_WORD)
+static MVMuint16 *cclass_blocks[CCLASS_NUM_BLOCKS];
+
+#if defined(__SSSE3__)
+/* For each class, indexed by bit number, a table from the low nibble of an
+ * ASCII char to a bitmask of the high nibbles that are in the class with
+ * it, so that 16 chars can be classified at a time with a pair of byte
+ * shuffles. */
+static MVMuint8 cclass_ascii_nibbles[14][16];
+#endif
+
+static MVMint64 compute_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGrapheme32 cp);
+static MVMuint16 * build_cclass_block(MVMThreadContext *tc, MVMuint32 block_idx);
+
 /* Resolves various unicode property values that we'll need. */
 void MVM_string_cclass_init(MVMThreadContext *tc) {
     UPV_Nd = MVM_unicode_name_to_property_value_code(tc,
@@ -1288,13 +1882,25 @@ void MVM_string_cclass_init(MVMThreadContext *tc) {
     UPV_Po = MVM_unicode_name_to_property_value_code(tc,
         MVM_UNICODE_PROPERTY_GENERAL_CATEGORY,
         MVM_string_ascii_decode_nt(tc, tc->instance->VMString, "Po"));
-}
 
-/* Checks if the specified grapheme is in the given character class. */
-static MVMint64 grapheme_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGrapheme32 cp) {
-    if (cp < 0)
-        MVM_exception_throw_adhoc(tc, "Negative character fed to cclass: '%d'", cp);
+    if (!cclass_blocks[0]) {
+        build_cclass_block(tc, 0);
+#if defined(__SSSE3__)
+        {
+            const MVMuint16 *block = cclass_blocks[0];
+            MVMuint32 bit, c;
+            for (bit = 0; bit < 14; bit++)
+                for (c = 0; c < 0x80; c++)
+                    if (block[c] & (1 << bit))
+                        cclass_ascii_nibbles[bit][c & 0x0F] |= 1 << (c >> 4);
+        }
+#endif
+    }
+}
 
+/* Computes whether a codepoint is in the given character class from its
+ * Unicode properties. */
+static MVMint64 compute_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGrapheme32 cp) {
     switch (cclass) {
         case MVM_CCLASS_ANY:
             return 1;
@@ -1407,6 +2013,103 @@ static MVMint64 grapheme_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGra
     }
 }
 
+/* Builds the table block with the given index. Another thread may get there
+ * first, in which case we use its block. */
+static MVMuint16 * build_cclass_block(MVMThreadContext *tc, MVMuint32 block_idx) {
+    MVMuint16 *block = malloc(CCLASS_BLOCK_SIZE * sizeof(MVMuint16));
+    MVMuint32  i;
+    MVMint64   cclass;
+    for (i = 0; i < CCLASS_BLOCK_SIZE; i++) {
+        MVMGrapheme32 cp   = (MVMGrapheme32)((block_idx << CCLASS_BLOCK_SHIFT) + i);
+        MVMuint16     mask = 0;
+        for (cclass = 1; cclass <= MVM_CCLASS_WORD; cclass <<= 1)
+            if ((cclass & CCLASS_TABLED) && compute_cclass(tc, cclass, cp))
+                mask |= (MVMuint16)cclass;
+        block[i] = mask;
+    }
+    if (MVM_casptr(&cclass_blocks[block_idx], NULL, block) != NULL) {
+        free(block);
+        block = cclass_blocks[block_idx];
+    }
+    return block;
+}
+
+/* Checks if a character class is a single one of those in the tables. */
+static MVMint32 cclass_is_tabled(MVMint64 cclass) {
+    return cclass > 0 && (cclass & CCLASS_TABLED) == cclass && !(cclass & (cclass - 1));
+}
+
+/* Checks if the specified grapheme is in the given character class. */
+static MVMint64 grapheme_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMGrapheme32 cp) {
+    if (cp < 0)
+        MVM_exception_throw_adhoc(tc, "Negative character fed to cclass: '%d'", cp);
+    if (cp < 0x110000 && cclass_is_tabled(cclass)) {
+        MVMuint16 *block = cclass_blocks[cp >> CCLASS_BLOCK_SHIFT];
+        if (!block)
+            block = build_cclass_block(tc, cp >> CCLASS_BLOCK_SHIFT);
+        return (block[cp & (CCLASS_BLOCK_SIZE - 1)] & cclass) != 0;
+    }
+    return compute_cclass(tc, cclass, cp);
+}
+
+/* Searches from pos up to end for the first grapheme that is (if want is
+ * non-zero) or is not (if want is zero) in the character class, returning
+ * end if there is none. Flat 8-bit strings are scanned straight from the
+ * table's first block, which covers all of their graphemes; for ASCII ones
+ * that can be done 16 chars at a time. */
+static MVMint64 scan_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *s,
+        MVMint64 pos, MVMint64 end, MVMint64 want) {
+    MVMGraphemeIter gi;
+
+    if (cclass_is_tabled(cclass)) {
+        const MVMuint16 *block = cclass_blocks[0];
+        switch (s->body.storage_type) {
+        case MVM_STRING_GRAPHEME_ASCII: {
+            const MVMuint8 *blob = (const MVMuint8 *)s->body.storage.blob_ascii;
+#if defined(__SSSE3__)
+            MVMuint32 bit = 0;
+            __m128i   nibbles, high_bits, low_mask;
+            while (!(cclass & (1 << bit)))
+                bit++;
+            nibbles   = _mm_loadu_si128((const __m128i *)cclass_ascii_nibbles[bit]);
+            high_bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+            low_mask  = _mm_set1_epi8(0x0F);
+            while (pos + 16 <= end) {
+                __m128i chunk = _mm_loadu_si128((const __m128i *)(blob + pos));
+                __m128i hit   = _mm_and_si128(
+                    _mm_shuffle_epi8(nibbles, _mm_and_si128(chunk, low_mask)),
+                    _mm_shuffle_epi8(high_bits, _mm_and_si128(_mm_srli_epi16(chunk, 4), low_mask)));
+                int misses = _mm_movemask_epi8(_mm_cmpeq_epi8(hit, _mm_setzero_si128()));
+                if (misses != (want ? 0xFFFF : 0))
+                    break;
+                pos += 16;
+            }
+#endif
+            for (; pos < end; pos++)
+                if (((block[blob[pos]] & cclass) != 0) == (want != 0))
+                    return pos;
+            return end;
+        }
+        case MVM_STRING_GRAPHEME_8: {
+            const MVMGrapheme8 *blob = s->body.storage.blob_8;
+            for (; pos < end; pos++)
+                if (((block[blob[pos]] & cclass) != 0) == (want != 0))
+                    return pos;
+            return end;
+        }
+        }
+    }
+
+    MVM_string_gi_init(tc, &gi, s);
+    MVM_string_gi_move_to(tc, &gi, pos);
+    for (; pos < end; pos++) {
+        MVMGrapheme32 g = MVM_string_gi_get_grapheme(tc, &gi);
+        if ((grapheme_is_cclass(tc, cclass, g) != 0) == (want != 0))
+            return pos;
+    }
+    return end;
+}
+
 /* Checks if the character at the specified offset is a member of the
  * indicated character class. */
 MVMint64 MVM_string_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *s, MVMint64 offset) {
@@ -1419,46 +2122,26 @@ MVMint64 MVM_string_is_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *
 
 /* Searches for the next char that is in the specified character class. */
 MVMint64 MVM_string_find_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *s, MVMint64 offset, MVMint64 count) {
-    MVMGraphemeIter gi;
-    MVMint64        length = MVM_string_graphs(tc, s);
-    MVMint64        end    = offset + count;
-    MVMint64        pos;
+    MVMint64 length = MVM_string_graphs(tc, s);
+    MVMint64 end    = offset + count;
 
     if (offset < 0 || offset >= length)
         return end;
     end = length < end ? length : end;
 
-    MVM_string_gi_init(tc, &gi, s);
-    MVM_string_gi_move_to(tc, &gi, offset);
-    for (pos = offset; pos < end; pos++) {
-        MVMGrapheme32 g = MVM_string_gi_get_grapheme(tc, &gi);
-        if (grapheme_is_cclass(tc, cclass, g) > 0)
-            return pos;
-    }
-
-    return end;
+    return scan_cclass(tc, cclass, s, offset, end, 1);
 }
 
 /* Searches for the next char that is not in the specified character class. */
 MVMint64 MVM_string_find_not_cclass(MVMThreadContext *tc, MVMint64 cclass, MVMString *s, MVMint64 offset, MVMint64 count) {
-    MVMGraphemeIter gi;
-    MVMint64        length = MVM_string_graphs(tc, s);
-    MVMint64        end    = offset + count;
-    MVMint64        pos;
+    MVMint64 length = MVM_string_graphs(tc, s);
+    MVMint64 end    = offset + count;
 
     if (offset < 0 || offset >= length)
         return offset;
     end = length < end ? length : end;
 
-    MVM_string_gi_init(tc, &gi, s);
-    MVM_string_gi_move_to(tc, &gi, offset);
-    for (pos = offset; pos < end; pos++) {
-        MVMGrapheme32 g = MVM_string_gi_get_grapheme(tc, &gi);
-        if (grapheme_is_cclass(tc, cclass, g) == 0)
-            return pos;
-    }
-
-    return end;
+    return scan_cclass(tc, cclass, s, offset, end, 0);
 }
 
 static MVMint16   encoding_name_init         = 0;
@@ -1507,9 +2190,16 @@ MVMString * MVM_string_chr(MVMThreadContext *tc, MVMGrapheme32 g) {
     if (g < 0)
         MVM_exception_throw_adhoc(tc, "chr codepoint cannot be negative");
     s = (MVMString *)REPR(tc->instance->VMString)->allocate(tc, STABLE(tc->instance->VMString));
-    s->body.storage_type       = MVM_STRING_GRAPHEME_32;
-    s->body.storage.blob_32    = malloc(sizeof(MVMGrapheme32));
-    s->body.storage.blob_32[0] = g;
+    if (g <= 255) {
+        s->body.storage_type      = MVM_STRING_GRAPHEME_8;
+        s->body.storage.blob_8    = malloc(1);
+        s->body.storage.blob_8[0] = (MVMGrapheme8)g;
+    }
+    else {
+        s->body.storage_type       = MVM_STRING_GRAPHEME_32;
+        s->body.storage.blob_32    = malloc(sizeof(MVMGrapheme32));
+        s->body.storage.blob_32[0] = g;
+    }
     s->body.num_graphs         = 1;
     return s;
 }
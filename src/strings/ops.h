@@ -33,8 +33,10 @@ MVM_STATIC_INLINE MVMuint32 MVM_string_codes(MVMThreadContext *tc, MVMString *s)
     return s->body.num_graphs; /* Don't do NFG yet; this will do us. */
 }
 
+void MVM_string_set_blob_32(MVMThreadContext *tc, MVMString *s, MVMGrapheme32 *blob, MVMuint32 graphs);
 MVMGrapheme32 MVM_string_get_grapheme_at_nocheck(MVMThreadContext *tc, MVMString *a, MVMint64 index);
 MVMint64 MVM_string_equal(MVMThreadContext *tc, MVMString *a, MVMString *b);
+MVMuint32 MVM_string_hash_code(MVMThreadContext *tc, MVMString *s);
 MVMint64 MVM_string_index(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
 MVMint64 MVM_string_index_from_end(MVMThreadContext *tc, MVMString *haystack, MVMString *needle, MVMint64 start);
 MVMString * MVM_string_concatenate(MVMThreadContext *tc, MVMString *a, MVMString *b);
@@ -52,6 +54,8 @@ MVMString * MVM_string_uc(MVMThreadContext *tc, MVMString *s);
 MVMString * MVM_string_lc(MVMThreadContext *tc, MVMString *s);
 MVMString * MVM_string_tc(MVMThreadContext *tc, MVMString *s);
 MVMString * MVM_string_decode(MVMThreadContext *tc, MVMObject *type_object, char *Cbuf, MVMint64 byte_length, MVMint64 encoding_flag);
+MVMuint32 MVM_string_check_encode_range(MVMThreadContext *tc, MVMString *s, MVMint64 start, MVMint64 length);
+void MVM_string_encode_range_bytes(MVMThreadContext *tc, MVMString *s, MVMuint32 start, MVMuint32 length, MVMuint8 *out, MVMuint8 max);
 MVMuint8 * MVM_string_encode(MVMThreadContext *tc, MVMString *s, MVMint64 start, MVMint64 length, MVMuint64 *output_size, MVMint64 encoding_flag);
 void MVM_string_encode_to_buf(MVMThreadContext *tc, MVMString *s, MVMString *enc_name, MVMObject *buf);
 MVMString * MVM_string_decode_from_buf(MVMThreadContext *tc, MVMObject *buf, MVMString *enc_name);
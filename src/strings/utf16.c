@@ -75,8 +75,7 @@ MVMString * MVM_string_utf16_decode(MVMThreadContext *tc,
     }
 
     /* result->body.codes  = str_pos; */
-    result->body.storage_type = MVM_STRING_GRAPHEME_32;
-    result->body.num_graphs   = str_pos;
+    MVM_string_set_blob_32(tc, result, result->body.storage.blob_32, str_pos);
 
     return result;
 }
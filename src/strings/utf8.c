@@ -1,4 +1,12 @@
 #include "moar.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_SSE2 1
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif UTF8_SSE2
+#include <emmintrin.h>
+#endif
 
 /* The below section has an MIT-style license, included here.
 
@@ -183,91 +191,215 @@ static void *utf8_encode(void *bytes, MVMCodepoint cp)
 
  /* end not_gerd section */
 
-#define UTF8_MAXINC (32 * 1024 * 1024)
+/* Returns how many bytes at the start of the buffer are ASCII. This is the
+ * kernel of the decoders' fast path: most text that passes through them is
+ * entirely or mostly ASCII, and runs of it need no decoding at all. */
+static size_t ascii_prefix_length(const MVMuint8 *bytes, size_t length) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    while (i + 32 <= length) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *)(bytes + i));
+        if (_mm256_movemask_epi8(chunk))
+            break;
+        i += 32;
+    }
+#endif
+#if UTF8_SSE2
+    while (i + 16 <= length) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(bytes + i));
+        if (_mm_movemask_epi8(chunk))
+            break;
+        i += 16;
+    }
+#endif
+    while (i + 8 <= length) {
+        MVMuint64 word;
+        memcpy(&word, bytes + i, 8);
+        if (word & 0x8080808080808080ULL)
+            break;
+        i += 8;
+    }
+    while (i < length && bytes[i] < 0x80)
+        i++;
+    return i;
+}
+
+/* Throws an exception for malformed UTF-8, reporting the line and column of
+ * the sequence starting at pos. Everything before it was already found to
+ * be valid, so we can count codepoints by their lead bytes. */
+static void throw_malformed(MVMThreadContext *tc, const MVMuint8 *utf8, size_t pos) {
+    MVMint32 line_ending = 0;
+    MVMint32 line = 1;
+    MVMint32 col  = 1;
+    size_t   i;
+    for (i = 0; i < pos; i++) {
+        MVMuint8 byte = utf8[i];
+        if ((byte & 0xC0) == 0x80) {
+            /* continuation byte; not a codepoint of its own */
+        }
+        else if (!line_ending && (byte == 10 || byte == 13)) {
+            /* Detect the style of line endings.
+             * Select whichever comes first.
+             * First or only part of first line ending. */
+            line_ending = byte;
+            col = 1; line++;
+        }
+        else if (line_ending && byte == line_ending) {
+            /* first or only part of next line ending */
+            col = 1; line++;
+        }
+        else if (byte == 10 || byte == 13) {
+            /* second part of line ending; ignore */
+        }
+        else /* non-line ending codepoint */
+            col++;
+    }
+    MVM_exception_throw_adhoc(tc, "Malformed UTF-8 at line %u col %u", line, col);
+}
 
 /* Decodes the specified number of bytes of utf8 into an NFG string, creating
  * a result of the specified type. The type must have the MVMString REPR.
- * Only bring in the raw codepoints for now. */
+ * Only bring in the raw codepoints for now.
+ *
+ * A first pass validates the input and counts the codepoints, skipping over
+ * ASCII runs, so the result buffer can be allocated at its exact size (and
+ * in the narrowest storage that fits). Pure ASCII input is just copied. */
 MVMString * MVM_string_utf8_decode(MVMThreadContext *tc, MVMObject *result_type, const MVMuint8 *utf8, size_t bytes) {
-    MVMString *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
-    MVMint32 count = 0;
-    MVMCodepoint codepoint;
-    MVMint32 line_ending = 0;
-    MVMint32 state = 0;
-    MVMint32 bufsize = bytes;
-    MVMGrapheme32 *buffer = malloc(sizeof(MVMGrapheme32) * bufsize);
-    size_t orig_bytes;
-    const char *orig_utf8;
-    MVMint32 line;
-    MVMint32 col;
-
-    orig_bytes = bytes;
-    orig_utf8 = utf8;
-
-    for (; bytes; ++utf8, --bytes) {
-        switch(decode_utf8_byte(&state, &codepoint, *utf8)) {
-        case UTF8_ACCEPT: /* got a codepoint */
-            if (count == bufsize) { /* if the buffer's full make a bigger one */
-                buffer = realloc(buffer, sizeof(MVMGrapheme32) * (
-                    bufsize >= UTF8_MAXINC ? (bufsize += UTF8_MAXINC) : (bufsize *= 2)
-                ));
-            }
-            buffer[count++] = codepoint; /* XXX NFG needs a change here */
+    MVMString    *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
+    size_t        pos    = ascii_prefix_length(utf8, bytes);
+    size_t        count  = pos;
+    size_t        seq_start, i, out;
+    MVMCodepoint  codepoint = 0;
+    MVMCodepoint  widest    = 0;
+    MVMint32      state     = 0;
+
+    if (pos == bytes) {
+        result->body.storage_type       = MVM_STRING_GRAPHEME_ASCII;
+        result->body.storage.blob_ascii = malloc(bytes);
+        memcpy(result->body.storage.blob_ascii, utf8, bytes);
+        result->body.num_graphs         = bytes;
+        return result;
+    }
+
+    seq_start = pos;
+    while (pos < bytes) {
+        if (state == UTF8_ACCEPT && utf8[pos] < 0x80) {
+            size_t run = ascii_prefix_length(utf8 + pos, bytes - pos);
+            count    += run;
+            pos      += run;
+            seq_start = pos;
+            continue;
+        }
+        switch(decode_utf8_byte(&state, &codepoint, utf8[pos++])) {
+        case UTF8_ACCEPT:
+            count++;
+            if (codepoint > widest)
+                widest = codepoint;
+            seq_start = pos;
             break;
         case UTF8_REJECT:
-            /* found a malformed sequence; parse it again this time tracking
-             * line and col numbers. */
-            bytes = orig_bytes; utf8 = orig_utf8; state = 0; line = 1; col = 1;
-            for (; bytes; ++utf8, --bytes) {
-                switch(decode_utf8_byte(&state, &codepoint, *utf8)) {
-                case UTF8_ACCEPT:
-                    /* this could be reorganized into several nested ugly if/else :/ */
-                    if (!line_ending && (codepoint == 10 || codepoint == 13)) {
-                        /* Detect the style of line endings.
-                         * Select whichever comes first.
-                         * First or only part of first line ending. */
-                        line_ending = codepoint;
-                        col = 1; line++;
-                    }
-                    else if (line_ending && codepoint == line_ending) {
-                        /* first or only part of next line ending */
-                        col = 1; line++;
-                    }
-                    else if (codepoint == 10 || codepoint == 13) {
-                        /* second part of line ending; ignore */
-                    }
-                    else /* non-line ending codepoint */
-                        col++;
-                    break;
-                case UTF8_REJECT:
-                    MVM_exception_throw_adhoc(tc, "Malformed UTF-8 at line %u col %u", line, col);
-                }
-            }
-            MVM_exception_throw_adhoc(tc, "Concurrent modification of UTF-8 input buffer!");
-            break;
+            throw_malformed(tc, utf8, seq_start);
         }
     }
     if (state != UTF8_ACCEPT)
         MVM_exception_throw_adhoc(tc, "Malformed termination of UTF-8 string");
 
-    /* just keep the same buffer as the MVMString's buffer.  Later
-     * we can add heuristics to resize it if we have enough free
-     * memory */
-    if (bufsize - count > 4) {
-        buffer = realloc(buffer, count * sizeof(MVMGrapheme32));
-        bufsize = count;
+    /* The input is known to be valid now, so the second pass can decode by
+     * the lead bytes; it only checks it doesn't run off either buffer. */
+    i = out = 0;
+    if (widest < 256) {
+        MVMGrapheme8 *buffer = malloc(count);
+        while (i < bytes && out < count) {
+            MVMuint8 byte = utf8[i];
+            if (byte < 0x80) {
+                size_t run = ascii_prefix_length(utf8 + i, bytes - i);
+                if (run > count - out)
+                    break;
+                memcpy(buffer + out, utf8 + i, run);
+                out += run;
+                i   += run;
+            }
+            else if (i + 1 < bytes) {
+                buffer[out++] = (MVMGrapheme8)(((byte & 0x1F) << 6) | (utf8[i + 1] & 0x3F));
+                i += 2;
+            }
+            else
+                break;
+        }
+        if (i != bytes || out != count) {
+            free(buffer);
+            MVM_exception_throw_adhoc(tc, "Concurrent modification of UTF-8 input buffer!");
+        }
+        result->body.storage_type    = MVM_STRING_GRAPHEME_8;
+        result->body.storage.blob_8  = buffer;
+        result->body.num_graphs      = count;
+    }
+    else {
+        MVMGrapheme32 *buffer = malloc(count * sizeof(MVMGrapheme32));
+        while (i < bytes && out < count) {
+            MVMuint8 byte = utf8[i];
+            if (byte < 0x80) {
+                size_t run = ascii_prefix_length(utf8 + i, bytes - i);
+                size_t k;
+                if (run > count - out)
+                    break;
+                for (k = 0; k < run; k++)
+                    buffer[out + k] = utf8[i + k];
+                out += run;
+                i   += run;
+            }
+            else if (byte < 0xE0 && i + 1 < bytes) {
+                buffer[out++] = ((byte & 0x1F) << 6) | (utf8[i + 1] & 0x3F);
+                i += 2;
+            }
+            else if (byte < 0xF0 && i + 2 < bytes) {
+                buffer[out++] = ((byte & 0x0F) << 12) | ((utf8[i + 1] & 0x3F) << 6)
+                              | (utf8[i + 2] & 0x3F);
+                i += 3;
+            }
+            else if (i + 3 < bytes) {
+                buffer[out++] = ((byte & 0x07) << 18) | ((utf8[i + 1] & 0x3F) << 12)
+                              | ((utf8[i + 2] & 0x3F) << 6) | (utf8[i + 3] & 0x3F);
+                i += 4;
+            }
+            else
+                break;
+        }
+        if (i != bytes || out != count) {
+            free(buffer);
+            MVM_exception_throw_adhoc(tc, "Concurrent modification of UTF-8 input buffer!");
+        }
+        result->body.storage_type    = MVM_STRING_GRAPHEME_32;
+        result->body.storage.blob_32 = buffer;
+        result->body.num_graphs      = count;
     }
-    result->body.storage.blob_32 = buffer;
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.num_graphs      = count;
 
     return result;
 }
 
+/* Finds the first byte in a run of ASCII that could be the last grapheme of
+ * one of the separators, returning its offset, or -1 if there is none. */
+static MVMint32 find_ascii_sep_end(const MVMDecodeStreamSeparators *sep_spec,
+        const MVMuint8 *bytes, MVMint32 length) {
+    MVMint32 i;
+    if (sep_spec->num_seps == 1) {
+        MVMGrapheme32  final = sep_spec->final_graphemes[0];
+        const MVMuint8 *found;
+        if (final < 0 || final >= 0x80)
+            return -1;
+        found = memchr(bytes, final, length);
+        return found ? (MVMint32)(found - bytes) : -1;
+    }
+    for (i = 0; i < length; i++)
+        if (MVM_string_decodestream_maybe_sep(sep_spec, bytes[i]))
+            return i;
+    return -1;
+}
+
 /* Decodes using a decodestream. Decodes as far as it can with the input
  * buffers, or until a stopper is reached. */
 void MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
-                                  MVMint32 *stopper_chars, MVMint32 *stopper_sep) {
+                                  MVMint32 *stopper_chars, const MVMDecodeStreamSeparators *stopper_sep) {
     MVMint32 count = 0, total = 0, stopped = 0;
     MVMint32 state = 0;
     MVMCodepoint codepoint = 0;
@@ -295,8 +427,41 @@ void MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
     while (cur_bytes) {
         /* Process this buffer. */
         MVMint32  pos   = cur_bytes == ds->bytes_head ? ds->bytes_head_pos : 0;
-        char     *bytes = cur_bytes->bytes;
+        MVMuint8 *bytes = (MVMuint8 *)cur_bytes->bytes;
         while (pos < cur_bytes->length) {
+            if (state == UTF8_ACCEPT && bytes[pos] < 0x80) {
+                /* Copy a run of ASCII straight into the buffer, stopping
+                 * early if it fills or we reach a stopper. */
+                MVMint32 run, k;
+                MVMint32 at_sep = 0;
+                if (count == bufsize) {
+                    MVM_string_decodestream_add_chars(tc, ds, buffer, bufsize);
+                    buffer = malloc(bufsize * sizeof(MVMGrapheme32));
+                    count = 0;
+                }
+                run = (MVMint32)ascii_prefix_length(bytes + pos, cur_bytes->length - pos);
+                if (run > bufsize - count)
+                    run = bufsize - count;
+                if (stopper_chars && run > *stopper_chars - total)
+                    run = *stopper_chars - total;
+                if (stopper_sep) {
+                    MVMint32 sep_end = find_ascii_sep_end(stopper_sep, bytes + pos, run);
+                    if (sep_end >= 0) {
+                        run    = sep_end + 1;
+                        at_sep = 1;
+                    }
+                }
+                for (k = 0; k < run; k++)
+                    buffer[count + k] = bytes[pos + k];
+                count += run;
+                total += run;
+                pos   += run;
+                last_accept_bytes = cur_bytes;
+                last_accept_pos = pos;
+                if (at_sep || (stopper_chars && *stopper_chars == total))
+                    goto done;
+                continue;
+            }
             switch(decode_utf8_byte(&state, &codepoint, bytes[pos++])) {
             case UTF8_ACCEPT:
                 if (count == bufsize) {
@@ -313,7 +478,7 @@ void MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
                 total++;
                 if (stopper_chars && *stopper_chars == total)
                     goto done;
-                if (stopper_sep && *stopper_sep == codepoint)
+                if (stopper_sep && MVM_string_decodestream_maybe_sep(stopper_sep, codepoint))
                     goto done;
                 break;
             case UTF8_REJECT:
@@ -332,42 +497,171 @@ void MVM_string_utf8_decodestream(MVMThreadContext *tc, MVMDecodeStream *ds,
     MVM_string_decodestream_discard_to(tc, ds, last_accept_bytes, last_accept_pos);
 }
 
-/* Encodes the specified string to UTF-8. */
+/* Narrows the run of graphemes below 0x80 at the start of the buffer into
+ * bytes, returning how many there were. The UTF-8 encoder's fast path. */
+static size_t narrow_ascii_32(const MVMGrapheme32 *in, size_t length, MVMuint8 *out) {
+    size_t i = 0;
+#if UTF8_SSE2
+    const __m128i high = _mm_set1_epi32(~0x7F);
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 8 <= length) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(in + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(in + i + 4));
+        __m128i any_high = _mm_and_si128(_mm_or_si128(a, b), high);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(any_high, zero)) != 0xFFFF)
+            break;
+        _mm_storel_epi64((__m128i *)(out + i),
+            _mm_packus_epi16(_mm_packs_epi32(a, b), zero));
+        i += 8;
+    }
+#endif
+    while (i < length && (MVMuint32)in[i] < 0x80) {
+        out[i] = (MVMuint8)in[i];
+        i++;
+    }
+    return i;
+}
+
+static void throw_unencodable(MVMThreadContext *tc, MVMuint32 pos, MVMGrapheme32 g) {
+    MVM_exception_throw_adhoc(tc,
+        "Error encoding UTF-8 string near grapheme position %u with codepoint %d",
+            pos, g);
+}
+
+/* Works out the size of the UTF-8 encoding of a substring, which must
+ * already have been range checked. Works a strand at a time. */
+static MVMuint64 encoded_size(MVMThreadContext *tc, MVMString *str, MVMuint32 start,
+        MVMuint32 length) {
+    MVMGraphemeIter gi;
+    MVMuint64       size = 0;
+    MVMuint32       done = 0;
+    MVM_string_gi_init(tc, &gi, str);
+    MVM_string_gi_move_to(tc, &gi, start);
+    while (done < length) {
+        MVMuint16  type;
+        void      *run;
+        MVMuint32  n = MVM_string_gi_next_run(tc, &gi, length - done, &type, &run);
+        MVMuint32  i;
+        switch (type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+            size += n;
+            break;
+        case MVM_STRING_GRAPHEME_8: {
+            MVMGrapheme8 *blob = (MVMGrapheme8 *)run;
+            MVMuint32     high = 0;
+            for (i = 0; i < n; i++)
+                high += blob[i] >> 7;
+            size += n + high;
+            break;
+        }
+        case MVM_STRING_GRAPHEME_32: {
+            MVMGrapheme32 *blob = (MVMGrapheme32 *)run;
+            for (i = 0; i < n; i++) {
+                unsigned cc;
+                if ((MVMuint32)blob[i] < 0x80) {
+                    size++;
+                    continue;
+                }
+                cc = classify(blob[i]);
+                if (!(cc & CP_CHAR))
+                    throw_unencodable(tc, start + done + i, blob[i]);
+                size += cc & U8_QUAD ? 4 : cc & U8_TRIPLE ? 3 : cc & U8_DOUBLE ? 2 : 1;
+            }
+            break;
+        }
+        }
+        done += n;
+    }
+    return size;
+}
+
+/* Encodes a substring, which must already have been range checked and
+ * sized, into the supplied buffer. Runs of ASCII are copied or narrowed in
+ * bulk; everything else goes through utf8_encode. */
+static MVMuint8 * encode_range(MVMThreadContext *tc, MVMString *str, MVMuint32 start,
+        MVMuint32 length, MVMuint8 *out) {
+    MVMGraphemeIter gi;
+    MVMuint32       done = 0;
+    MVM_string_gi_init(tc, &gi, str);
+    MVM_string_gi_move_to(tc, &gi, start);
+    while (done < length) {
+        MVMuint16  type;
+        void      *run;
+        MVMuint32  n = MVM_string_gi_next_run(tc, &gi, length - done, &type, &run);
+        MVMuint32  i = 0;
+        switch (type) {
+        case MVM_STRING_GRAPHEME_ASCII:
+            memcpy(out, run, n);
+            out += n;
+            break;
+        case MVM_STRING_GRAPHEME_8: {
+            MVMGrapheme8 *blob = (MVMGrapheme8 *)run;
+            while (i < n) {
+                size_t ascii = ascii_prefix_length(blob + i, n - i);
+                memcpy(out, blob + i, ascii);
+                out += ascii;
+                i   += ascii;
+                while (i < n && blob[i] >= 0x80) {
+                    out[0] = (MVMuint8)(0xC0 | (blob[i] >> 6));
+                    out[1] = (MVMuint8)(0x80 | (blob[i] & 0x3F));
+                    out += 2;
+                    i++;
+                }
+            }
+            break;
+        }
+        case MVM_STRING_GRAPHEME_32: {
+            MVMGrapheme32 *blob = (MVMGrapheme32 *)run;
+            while (i < n) {
+                size_t ascii = narrow_ascii_32(blob + i, n - i, out);
+                out += ascii;
+                i   += ascii;
+                while (i < n && (MVMuint32)blob[i] >= 0x80) {
+                    MVMuint8 *next = utf8_encode(out, blob[i]);
+                    if (!next)
+                        throw_unencodable(tc, start + done + i, blob[i]);
+                    out = next;
+                    i++;
+                }
+            }
+            break;
+        }
+        }
+        done += n;
+    }
+    return out;
+}
+
+/* Works out how many bytes encoding the specified substring to UTF-8 will
+ * produce, for callers that want to encode into a buffer of their own. */
+MVMuint64 MVM_string_utf8_encoded_size(MVMThreadContext *tc, MVMString *str,
+        MVMint64 start, MVMint64 length) {
+    MVMuint32 lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    return encoded_size(tc, str, (MVMuint32)start, lengthu);
+}
+
+/* Encodes the specified substring to UTF-8 into the supplied buffer, which
+ * must have room for MVM_string_utf8_encoded_size bytes. Returns the number
+ * of bytes written. */
+MVMuint64 MVM_string_utf8_encode_into(MVMThreadContext *tc, MVMString *str,
+        MVMint64 start, MVMint64 length, MVMuint8 *buffer) {
+    MVMuint32 lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    return encode_range(tc, str, (MVMuint32)start, lengthu, buffer) - buffer;
+}
+
+/* Encodes the specified string to UTF-8. The result is sized exactly, plus
+ * two NUL bytes of padding in case `say` wants to append a \r\n or \n. */
 MVMuint8 * MVM_string_utf8_encode_substr(MVMThreadContext *tc,
         MVMString *str, MVMuint64 *output_size, MVMint64 start, MVMint64 length) {
-    /* XXX This is terribly wrong when we get to doing NFG properly too. One graph may
-     * expand to loads of codepoints and overflow the buffer. */
-    MVMuint8        *result;
-    MVMuint8        *arr;
-    MVMuint32        i;
-    MVMStringIndex   strgraphs = MVM_string_graphs(tc, str);
-    MVMCodepointIter ci;
-
-    if (length == -1)
-        length = strgraphs;
-
-    /* must check start first since it's used in the length check */
-    if (start < 0 || start > strgraphs)
-        MVM_exception_throw_adhoc(tc, "start out of range");
-    if (length < 0 || start + length > strgraphs)
-        MVM_exception_throw_adhoc(tc, "length out of range");
-
-    /* give it two spaces for padding in case `say` wants to append a \r\n or \n */
-    result = malloc(sizeof(MVMint32) * length + 2);
-    arr = result;
-
-    memset(result, 0, sizeof(MVMint32) * length + 2);
-    MVM_string_ci_init(tc, &ci, str);
-    i = 0;
-    while (i < length && (arr = utf8_encode(arr, MVM_string_ci_get_codepoint(tc, &ci))))
-        i++;
-    if (!arr)
-        MVM_exception_throw_adhoc(tc,
-            "Error encoding UTF-8 string near grapheme position %d with codepoint %d",
-                i - 1, MVM_string_get_grapheme_at_nocheck(tc, str, i-1));
+    MVMuint32  lengthu = MVM_string_check_encode_range(tc, str, start, length);
+    MVMuint64  size    = encoded_size(tc, str, (MVMuint32)start, lengthu);
+    MVMuint8  *result  = malloc(size + 2);
+
+    encode_range(tc, str, (MVMuint32)start, lengthu, result);
+    result[size] = result[size + 1] = 0;
 
     if (output_size)
-        *output_size = (MVMuint64)(arr ? arr - result : 0);
+        *output_size = size;
 
     return result;
 }
@@ -380,14 +674,12 @@ MVMuint8 * MVM_string_utf8_encode(MVMThreadContext *tc, MVMString *str, MVMuint6
 
 /* Encodes the specified string to a UTF-8 C string. */
 char * MVM_string_utf8_encode_C_string(MVMThreadContext *tc, MVMString *str) {
-    MVMuint64 output_size, i;
-    char * result;
-    MVMuint8 * utf8_string = MVM_string_utf8_encode(tc, str, &output_size);
     /* this is almost always called from error-handling code. Don't care if it
      * contains embedded NULs. XXX TODO: Make sure all uses of this free what it returns */
-    result = malloc(output_size + 1);
-    memcpy(result, utf8_string, output_size);
-    free(utf8_string);
-    result[output_size] = (char)0;
+    MVMuint32  length = MVM_string_graphs(tc, str);
+    MVMuint64  size   = encoded_size(tc, str, 0, length);
+    char      *result = malloc(size + 1);
+    encode_range(tc, str, 0, length, (MVMuint8 *)result);
+    result[size] = (char)0;
     return result;
 }
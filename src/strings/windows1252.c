@@ -135,11 +135,23 @@ MVMString * MVM_string_windows1252_decode(MVMThreadContext *tc,
     MVMString *result = (MVMString *)REPR(result_type)->allocate(tc, STABLE(result_type));
     size_t i;
 
-    result->body.num_graphs      = bytes;
-    result->body.storage_type    = MVM_STRING_GRAPHEME_32;
-    result->body.storage.blob_32 = malloc(sizeof(MVMGrapheme32) * bytes);
+    /* Outside of 0x80 to 0x9F, each byte is the codepoint itself; if there
+     * are none in that range, the bytes can be used as 8-bit storage. */
+    result->body.num_graphs = bytes;
     for (i = 0; i < bytes; i++)
-        result->body.storage.blob_32[i] = WINDOWS1252_CHAR_TO_CP(windows1252[i]);
+        if (windows1252[i] >= 0x80 && windows1252[i] <= 0x9F)
+            break;
+    if (i == bytes) {
+        result->body.storage_type   = MVM_STRING_GRAPHEME_8;
+        result->body.storage.blob_8 = malloc(bytes);
+        memcpy(result->body.storage.blob_8, windows1252, bytes);
+    }
+    else {
+        result->body.storage_type    = MVM_STRING_GRAPHEME_32;
+        result->body.storage.blob_32 = malloc(sizeof(MVMGrapheme32) * bytes);
+        for (i = 0; i < bytes; i++)
+            result->body.storage.blob_32[i] = WINDOWS1252_CHAR_TO_CP(windows1252[i]);
+    }
     return result;
 }
 
@@ -164,14 +176,25 @@ MVMuint8 * MVM_string_windows1252_encode_substr(MVMThreadContext *tc, MVMString
     result = malloc(lengthu + 1);
     if (str->body.storage_type == MVM_STRING_GRAPHEME_ASCII) {
         /* No encoding needed; directly copy. */
-        memcpy(result, str->body.storage.blob_ascii, lengthu);
+        memcpy(result, str->body.storage.blob_ascii + startu, lengthu);
+        result[lengthu] = 0;
+    }
+    else if (str->body.storage_type == MVM_STRING_GRAPHEME_8) {
+        /* Only codepoints from 128 up to 152 need mapping. */
+        MVMGrapheme8 *blob_8 = str->body.storage.blob_8 + startu;
+        MVMuint32     i;
+        for (i = 0; i < lengthu; i++)
+            result[i] = blob_8[i] >= 128 && blob_8[i] < 152
+                ? windows1252_cp_to_char(blob_8[i])
+                : blob_8[i];
         result[lengthu] = 0;
     }
     else {
-        MVMuint32 i = 0;
+        MVMuint32 i;
         MVMCodepointIter ci;
         MVM_string_ci_init(tc, &ci, str);
-        while (MVM_string_ci_has_more(tc, &ci)) {
+        MVM_string_ci_move_to(tc, &ci, startu);
+        for (i = 0; i < lengthu; i++) {
             MVMCodepoint codepoint = MVM_string_ci_get_codepoint(tc, &ci);
             if ((codepoint >= 0 && codepoint < 128) || (codepoint >= 152 && codepoint < 256))
                 result[i] = (MVMuint8)codepoint;
@@ -179,7 +202,6 @@ MVMuint8 * MVM_string_windows1252_encode_substr(MVMThreadContext *tc, MVMString
                 result[i] = '?';
             else
                 result[i] = windows1252_cp_to_char(codepoint);
-            i++;
         }
         result[i] = 0;
     }
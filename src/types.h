@@ -42,10 +42,14 @@ typedef struct MVMExtRegistry MVMExtRegistry;
 typedef struct MVMFixedSizeAlloc MVMFixedSizeAlloc;
 typedef struct MVMFixedSizeAllocFreeListEntry MVMFixedSizeAllocFreeListEntry;
 typedef struct MVMFixedSizeAllocSizeClass MVMFixedSizeAllocSizeClass;
+typedef struct MVMFixedSizeAllocThread MVMFixedSizeAllocThread;
+typedef struct MVMFixedSizeAllocThreadSizeClass MVMFixedSizeAllocThreadSizeClass;
 typedef struct MVMFrame MVMFrame;
 typedef struct MVMFrameHandler MVMFrameHandler;
 typedef struct MVMGen2Allocator MVMGen2Allocator;
+typedef struct MVMGen2LargeObject MVMGen2LargeObject;
 typedef struct MVMGen2SizeClass MVMGen2SizeClass;
+typedef struct MVMGCHeapStats MVMGCHeapStats;
 typedef struct MVMGCPassedWork MVMGCPassedWork;
 typedef struct MVMGCWorklist MVMGCWorklist;
 typedef struct MVMHash MVMHash;
@@ -67,6 +71,10 @@ typedef struct MVMLexicalRegistry MVMLexicalRegistry;
 typedef struct MVMLexotic MVMLexotic;
 typedef struct MVMLexoticBody MVMLexoticBody;
 typedef struct MVMLoadedCompUnitName MVMLoadedCompUnitName;
+typedef struct MVMMethodCacheEntry MVMMethodCacheEntry;
+typedef struct MVMAttrCacheEntry MVMAttrCacheEntry;
+typedef union  MVMInlineCacheEntry MVMInlineCacheEntry;
+typedef struct MVMInlineCacheSite MVMInlineCacheSite;
 typedef struct MVMNFA MVMNFA;
 typedef struct MVMNFABody MVMNFABody;
 typedef struct MVMNFAStateInfo MVMNFAStateInfo;
@@ -117,6 +125,7 @@ typedef struct MVMP6opaque MVMP6opaque;
 typedef struct MVMP6opaqueBody MVMP6opaqueBody;
 typedef struct MVMP6opaqueBoxedTypeMap MVMP6opaqueBoxedTypeMap;
 typedef struct MVMP6opaqueNameMap MVMP6opaqueNameMap;
+typedef struct MVMP6opaqueNameIndexEntry MVMP6opaqueNameIndexEntry;
 typedef struct MVMP6opaqueREPRData MVMP6opaqueREPRData;
 typedef struct MVMP6str MVMP6str;
 typedef struct MVMP6strBody MVMP6strBody;
@@ -179,6 +188,8 @@ typedef struct MVMIOSyncPipeData MVMIOSyncPipeData;
 typedef struct MVMDecodeStream MVMDecodeStream;
 typedef struct MVMDecodeStreamBytes MVMDecodeStreamBytes;
 typedef struct MVMDecodeStreamChars MVMDecodeStreamChars;
+typedef struct MVMDecodeStreamSeparators MVMDecodeStreamSeparators;
+typedef struct MVMInternedString MVMInternedString;
 typedef struct MVMNativeCallback MVMNativeCallback;
 typedef struct MVMNativeCallbackCacheHead MVMNativeCallbackCacheHead;
 typedef struct MVMJitGraph MVMJitGraph;